@@ -1,180 +1,321 @@
+#pragma once
 #include <cstdint>
 #include <cstring>
+#include "RingBuffer.h"
+#include "MuLawCodec.h"
+
+// Bucket-brigade delay: 12-bit samples clocked through a line of MaxStages
+// stages at half the sample rate, read back through an interpolated tap,
+// low-passed and fed back.
+//
+// Stage storage is an inline power-of-two ring, sized at compile time, so
+// there is no heap allocation: declare the delay static or global and its
+// RAM shows up in the link map with everything else.  Stage is the format
+// of each stage:
+//
+//   int8_t   the top 8 bits of the sample: the classic gritty sound, 1 byte
+//   uint8_t  µ-law (MuLawCodec), companded as the NE570 around a real BBD
+//            does: 1 byte, but quiet signals keep their low bits, so the
+//            noise floor follows the signal instead of sitting at 8 bits
+//   int16_t  the whole 12 bits, 2 bytes
+//
+//   static BucketBrigadeDelay<65535> bbd;            // 64 KB, up to 2.7 s
+//   static BucketBrigadeDelay<65535, uint8_t> bbd;   // 64 KB, up to 2.7 s, companded
+//   static BucketBrigadeDelay<24000, int16_t> bbd;   // 64 KB, up to 1 s, clean
+//
+// Two ways to set the delay time:
+//
+//   Clocked = false  the stages clock at a fixed 24 kHz and the delay is an
+//                    interpolated read position anywhere along them.  Any
+//                    delay up to MaxStages × 2 samples; bandwidth is the
+//                    same at every delay.
+//
+//   Clocked = true   like a real BBD chip: the signal always passes through
+//                    all MaxStages stages, and the delay sets the clock rate
+//                    — MaxStages ticks per delay time, between the sample
+//                    rate (delay MaxStages samples) and 1/64 of it.  A tick
+//                    reads the last stage and writes the first; no random
+//                    access, no interpolation.  The input is low-passed and
+//                    the output smoothed by filters that track the clock, so
+//                    long delays lose treble as a real BBD does, and a delay
+//                    change glides the clock and bends the pitch of what is
+//                    already in the line.
+//
+//   static BucketBrigadeDelay<4096, int8_t, true> bbd;   // 4 KB, 85 ms .. 5.5 s
+//
+// processChorus() reads the fixed-clock line through up to three taps
+// instead of one, each swept by the same triangle LFO a third of a cycle
+// apart — the classic string-ensemble chorus — for the RAM of one line:
+//
+//   static BucketBrigadeDelay<1024> chorus;   // 1 KB, taps up to 42 ms
+//   chorus.setChorus(3, 480, 240, 600);       // 10 ms ± 5 ms at 0.6 Hz
+//   out = chorus.processChorus(in);
+
+// Stage formats: what a stage stores, the precision a stage is worked in
+// once read back (Value, VALUE_SHIFT bits short of 12), and the conversions
+template <class Stage> struct BbdStage;
+
+template <> struct BbdStage<int8_t> {
+    typedef int8_t Value;
+    static constexpr int VALUE_SHIFT = 4;
+    static inline int8_t store(int16_t sample12) { return (int8_t)(sample12 >> 4); }
+    static inline int8_t load(int8_t s) { return s; }
+};
+
+template <> struct BbdStage<uint8_t> {
+    typedef int16_t Value;
+    static constexpr int VALUE_SHIFT = 0;
+    static inline uint8_t store(int16_t sample12) { return MuLawCodec::encodeSample(sample12); }
+    static inline int16_t load(uint8_t s) { return MuLawCodec::decodeSample(s); }
+};
+
+template <> struct BbdStage<int16_t> {
+    typedef int16_t Value;
+    static constexpr int VALUE_SHIFT = 0;
+    static inline int16_t store(int16_t sample12) { return sample12; }
+    static inline int16_t load(int16_t s) { return s; }
+};
 
+template <uint32_t MaxStages, class Stage = int8_t, bool Clocked = false>
 class BucketBrigadeDelay {
-private:
-    int8_t* buffer;  // Changed to signed
-    uint16_t writePos;
-    uint16_t bufferSize;
+    typedef BbdStage<Stage> Format;    // int8_t, uint8_t (µ-law) or int16_t
+    typedef typename Format::Value Value;
+
+    static_assert(MaxStages >= 64, "BBD needs at least 64 stages");
+    static_assert(MaxStages <= 0xFFFF, "delay positions are 16.16 stages");
+
+    static constexpr int log2Ceil(uint32_t n) { return n <= 1 ? 0 : 1 + log2Ceil((n + 1) >> 1); }
 
     // Clock simulation (48kHz / 24kHz = clock every 2 samples)
+    static constexpr uint8_t CLOCK_DIVIDER = 2;
+
+    // Clocked mode: the clock glides to a new rate with this time constant
+    // (2^10 samples, ~21 ms), and runs no slower than 1/64 of the sample rate
+    static constexpr int      GLIDE_SHIFT = 10;
+    static constexpr uint32_t MIN_CLOCK   = 65536 / 64;
+
+    // Chorus: taps, and their phases around the LFO cycle
+    static constexpr int      CHORUS_TAPS = 3;
+    static constexpr uint32_t TAP_PHASE[CHORUS_TAPS] = { 0, 0x55555555u, 0xAAAAAAAAu };
+
+    // 12-bit samples lose their low 4 bits in 8-bit linear stages
+    static constexpr int STAGE_SHIFT = Format::VALUE_SHIFT;
+
+private:
+    RingBuffer<Stage, log2Ceil(MaxStages)> buffer;
+
     uint8_t clockCounter;
-    const uint8_t clockDivider = 2;
 
     // Filter state
-    int8_t filterState;  // Changed to signed
+    Value filterState;
     uint8_t filterCoeff;
-    int8_t clipThreshold;  // Changed to signed
+    int8_t clipThreshold;
 
     // Feedback control (0-255)
     uint8_t feedbackAmount;
 
-    // Delay control with sub-sample interpolation
-    uint32_t targetDelaySamples;
-    uint32_t currentDelaySamples;
+    // Delay control with sub-stage interpolation, in 16.16 stages
+    uint32_t targetDelayFP;
+    uint32_t currentDelayFP;
     int32_t delaySlewRate;
 
-    // Convert 12-bit signed sample to 8-bit signed for storage
-    inline int8_t pack12to8(int16_t sample12) {
-        // Sample is -2048 to +2047, shift down to -128 to +127
-        return static_cast<int8_t>((sample12 >> 4) & 0xFF);
+    // Clocked mode: stage clock in 16.16 ticks per sample, the filters that
+    // track it (Q4 states, Q12 coefficient) and the last stage read
+    uint32_t clockPhase;
+    uint32_t clockInc;
+    uint32_t targetInc;
+    int32_t  trackCoeff;
+    int32_t  antiAlias;
+    int32_t  recon[2];
+    Value    heldStage;
+
+    // Chorus: tap count, centre delay (16.16 stages), sweep depth (in
+    // 48kHz samples, ±), triangle LFO, and a lowpass state per tap
+    uint8_t  chorusTaps;
+    uint32_t chorusBaseFP;
+    int32_t  chorusDepth;
+    uint32_t lfoPhase;
+    uint32_t lfoInc;
+    Value    tapFilter[CHORUS_TAPS];
+
+    // Convert 12-bit signed sample to a stage for storage
+    inline Stage toStage(int16_t sample12) {
+        return Format::store(sample12);
     }
 
-    // Convert 8-bit signed back to 12-bit signed
-    inline int16_t unpack8to12(int8_t sample8) {
-        // Shift up from -128..+127 to -2048..+2032
-        return static_cast<int16_t>(sample8) << 4;
+    // Empty the line.  A zero byte is full scale in µ-law, so those stages
+    // are filled with the code for silence instead.
+    void clearStages() {
+        buffer.clear();
+        if (Format::load(0) != 0) {
+            const Stage silence = toStage(0);
+            for (int i = 0; i < buffer.SIZE; i++) buffer.at(i) = silence;
+        }
     }
 
-    // Simple one-pole lowpass filter (signed)
-    inline int8_t lowpass8(int8_t input) {
-        int16_t diff = input - filterState;
-        int16_t delta = (diff * filterCoeff) >> 8;
-        filterState += delta;
-        return filterState;
+    // Convert a stage value back to 12-bit signed
+    inline int16_t fromStage(Value v) {
+        return static_cast<int16_t>(v * (1 << STAGE_SHIFT));
     }
 
-    // Fast soft clipping (signed input/output)
-    inline int8_t softClip(int8_t input) {
-        int16_t x = input;
+    // Simple one-pole lowpass filter (signed), 8-bit coefficient
+    inline Value lowpass8(Value input, Value& state) {
+        int32_t diff = input - state;
+        int32_t delta = (diff * filterCoeff) >> 8;
+        state += delta;
+        return state;
+    }
+
+    // Fast soft clipping (signed input/output); thresholds are in 8-bit units
+    inline Value softClip(Value input) {
+        const int32_t threshold = (int32_t)clipThreshold << (4 - STAGE_SHIFT);
+        const int32_t limit     = 120 << (4 - STAGE_SHIFT);
+        int32_t x = input;
 
         // Scale up: x * 1.5 = x + x/2
         x = x + (x >> 1);
 
         // Piecewise soft clipping
-        if (x > clipThreshold) {
-            int16_t excess = x - clipThreshold;
-            x = clipThreshold + (excess >> 2);
-        } else if (x < -clipThreshold) {
-            int16_t excess = x + clipThreshold;
-            x = -clipThreshold + (excess >> 2);
+        if (x > threshold) {
+            int32_t excess = x - threshold;
+            x = threshold + (excess >> 2);
+        } else if (x < -threshold) {
+            int32_t excess = x + threshold;
+            x = -threshold + (excess >> 2);
         }
 
         // Hard limit (symmetric)
-        if (x > 120) x = 120;
-        if (x < -120) x = -120;
+        if (x > limit) x = limit;
+        if (x < -limit) x = -limit;
 
         // Scale back: x * 0.668 ≈ x * 2/3
         x = (x * 171) >> 8;
 
-        return (int8_t)x;
+        return (Value)x;
     }
 
     // Linear interpolation between buffer positions
-    inline int8_t interpolateRead(uint32_t delaySamplesFP) {
-        // Convert 48kHz samples to 24kHz stages
-        uint32_t delayStagesFP = delaySamplesFP >> 1;
-
+    inline Value interpolateRead(uint32_t delayStagesFP) {
         // Extract integer and fractional parts
         uint32_t delayStages = delayStagesFP >> 16;
         uint16_t frac = delayStagesFP & 0xFFFF;
 
         // Clamp to buffer bounds
-        if (delayStages >= (uint32_t)(bufferSize - 1)) {
-            delayStages = bufferSize - 2;
+        if (delayStages >= MaxStages - 1) {
+            delayStages = MaxStages - 2;
             frac = 0;
         }
 
-        // Calculate read positions (circular buffer)
-        int32_t readPos1 = (int32_t)writePos - (int32_t)delayStages;
-        if (readPos1 < 0) readPos1 += bufferSize;
-
-        int32_t readPos2 = readPos1 - 1;
-        if (readPos2 < 0) readPos2 += bufferSize;
-
-        // Read two adjacent samples
-        int8_t sample1 = buffer[readPos1];
-        int8_t sample2 = buffer[readPos2];
+        // Read two adjacent stages
+        Value sample1 = Format::load(buffer.tap(delayStages));
+        Value sample2 = Format::load(buffer.tap(delayStages + 1));
 
         // Linear interpolation (signed)
         int32_t interpolated = ((int32_t)sample1 * (65536 - frac) +
                                 (int32_t)sample2 * frac) >> 16;
 
-        return (int8_t)interpolated;
+        return (Value)interpolated;
     }
 
-public:
-    // Constructor
-    BucketBrigadeDelay(uint32_t maxDelaySamples,
-                       uint8_t filterAmount = 200,
-                       uint8_t clipAmount = 64,
-                       uint8_t feedback = 128,
-                       uint16_t slewRate = 100)
-        : writePos(0), clockCounter(0), filterState(0),
-          feedbackAmount(feedback) {
+    // One-pole cutoff at ~0.4 × the clock rate: 2π × 0.4 × clockInc / 65536 in Q12
+    static inline int32_t trackingCoeff(uint32_t inc) {
+        int32_t a = (int32_t)((inc * 5) >> 5);
+        return a > 4096 ? 4096 : a;
+    }
 
-        // Convert 48kHz samples to 12kHz stages
-        int32_t bs = maxDelaySamples / clockDivider;
+    int16_t processClocked(int16_t input12) {
+        // Glide the clock toward the rate for the target delay
+        if (clockInc != targetInc) {
+            int32_t step = ((int32_t)targetInc - (int32_t)clockInc) >> GLIDE_SHIFT;
+            clockInc = step ? clockInc + step : targetInc;
+            trackCoeff = trackingCoeff(clockInc);
+        }
+        const int32_t a = trackCoeff;
 
-        // Clamp to reasonable limits
-        if (bs < 64) bufferSize = 64;
-        if (bs > 0xFFFF) bufferSize = 0xFFFF;
-        bufferSize = bs;
+        // A tick reads the last stage before the write moves the line on
+        clockPhase += clockInc;
+        const bool clockTick = clockPhase >> 16;
+        clockPhase &= 0xFFFF;
+        if (clockTick) {
+            heldStage = lowpass8(Format::load(buffer.tap(MaxStages)), filterState);
+        }
 
-        // Allocate buffer
-        buffer = new int8_t[bufferSize];
-        memset(buffer, 0, bufferSize);  // Initialize to zero (center)
+        // Reconstruction: two poles over the held stage value
+        recon[0] += (((int32_t)fromStage(heldStage) * 16 - recon[0]) * a) >> 12;
+        recon[1] += ((recon[0] - recon[1]) * a) >> 12;
+        int16_t delayed12 = (int16_t)((recon[1] + 8) >> 4);
 
-        // Set filter coefficient
-        filterCoeff = 255 - filterAmount;
-        if (filterCoeff < 10) filterCoeff = 10;
-
-        // Set clipping threshold (signed)
-        clipThreshold = 100 - (clipAmount >> 2);
-        if (clipThreshold < 20) clipThreshold = 20;
+        // Mix input with feedback, as the fixed-clock mode
+        int32_t feedbackSignal = (delayed12 * (int16_t)feedbackAmount) >> 8;
+        int32_t mixedInput = ((input12 + feedbackSignal) * 171) >> 8;
+        if (mixedInput > 2047) mixedInput = 2047;
+        if (mixedInput < -2048) mixedInput = -2048;
 
-        // Initialize delay (in 16.16 fixed point)
-        targetDelaySamples = maxDelaySamples << 16;
-        currentDelaySamples = maxDelaySamples << 16;
+        // Anti-aliasing before the stages sample it
+        antiAlias += ((mixedInput * 16 - antiAlias) * a) >> 12;
+        if (clockTick) {
+            buffer.push(toStage((int16_t)((antiAlias + 8) >> 4)));
+        }
 
-        delaySlewRate = slewRate;
+        return delayed12;
     }
 
-    ~BucketBrigadeDelay() {
-        delete[] buffer;
+public:
+    static constexpr uint32_t STAGES = MaxStages;
+
+    // Starts at the maximum delay, or in Clocked mode with the clock at
+    // 24 kHz; slewRate is in 16.16 samples per sample (not used when Clocked)
+    BucketBrigadeDelay(uint8_t filterAmount = 200,
+                       uint8_t clipAmount = 64,
+                       uint8_t feedback = 128,
+                       uint16_t slewRate = 100)
+        : clockCounter(0), filterState(0),
+          feedbackAmount(feedback),
+          targetDelayFP(MaxStages << 16), currentDelayFP(MaxStages << 16),
+          clockPhase(0), clockInc(65536 / CLOCK_DIVIDER), targetInc(65536 / CLOCK_DIVIDER),
+          trackCoeff(trackingCoeff(65536 / CLOCK_DIVIDER)), antiAlias(0), heldStage(0),
+          chorusTaps(1), chorusBaseFP(0), chorusDepth(0), lfoPhase(0), lfoInc(0) {
+        recon[0] = recon[1] = 0;
+        memset(tapFilter, 0, sizeof(tapFilter));
+        clearStages();
+        setFilterAmount(filterAmount);
+        setClipAmount(clipAmount);
+        setSlewRate(slewRate);
     }
 
     // Process a single signed 12-bit sample at 48kHz (-2048 to +2047)
     // Returns delayed/processed signed 12-bit sample
     int16_t process(int16_t input12) {
+        if constexpr (Clocked) return processClocked(input12);
+
         bool clockTick = false;
 
         // Increment clock counter
         clockCounter++;
-        if (clockCounter >= clockDivider) {
+        if (clockCounter >= CLOCK_DIVIDER) {
             clockCounter = 0;
             clockTick = true;
         }
 
         // Smoothly interpolate current delay toward target
-        if (currentDelaySamples < targetDelaySamples) {
-            currentDelaySamples += delaySlewRate;
-            if (currentDelaySamples > targetDelaySamples) {
-                currentDelaySamples = targetDelaySamples;
+        if (currentDelayFP < targetDelayFP) {
+            currentDelayFP += delaySlewRate;
+            if (currentDelayFP > targetDelayFP) {
+                currentDelayFP = targetDelayFP;
             }
-        } else if (currentDelaySamples > targetDelaySamples) {
-            currentDelaySamples -= delaySlewRate;
-            if (currentDelaySamples < targetDelaySamples) {
-                currentDelaySamples = targetDelaySamples;
+        } else if (currentDelayFP > targetDelayFP) {
+            currentDelayFP -= delaySlewRate;
+            if (currentDelayFP < targetDelayFP) {
+                currentDelayFP = targetDelayFP;
             }
         }
 
         // Read delayed signal with interpolation
-        int8_t delayedRaw = interpolateRead(currentDelaySamples);
-        /* int8_t delayedClipped = softClip(delayedRaw); */
-        int8_t delayedClipped = delayedRaw;
-        int8_t delayedFiltered = lowpass8(delayedClipped);
-        int16_t delayed12 = unpack8to12(delayedFiltered);
+        Value delayedRaw = interpolateRead(currentDelayFP);
+        /* Value delayedClipped = softClip(delayedRaw); */
+        Value delayedClipped = delayedRaw;
+        Value delayedFiltered = lowpass8(delayedClipped, filterState);
+        int16_t delayed12 = fromStage(delayedFiltered);
 
         // Mix input with feedback (all signed arithmetic)
         int32_t feedbackSignal = (delayed12 * (int16_t)feedbackAmount) >> 8;
@@ -189,27 +330,70 @@ public:
 
         // Only update BBD buffer on clock ticks
         if (clockTick) {
-            buffer[writePos] = pack12to8((int16_t)mixedInput);
-
-            writePos++;
-            if (writePos >= bufferSize) {
-                writePos = 0;
-            }
+            buffer.push(toStage((int16_t)mixedInput));
         }
 
         return delayed12;
     }
 
+    // Chorus/ensemble on the fixed-clock line: the input (no feedback) is
+    // read back through the chorus taps, and the taps are averaged
+    int16_t processChorus(int16_t input12) {
+        static_assert(!Clocked, "chorus taps are interpolated reads of the fixed-clock line");
+        static const int32_t TAP_GAIN[CHORUS_TAPS + 1] = { 0, 65536, 32768, 21845 };
+
+        clockCounter++;
+        bool clockTick = clockCounter >= CLOCK_DIVIDER;
+        if (clockTick) clockCounter = 0;
+
+        int32_t sum = 0;
+        for (int k = 0; k < chorusTaps; k++) {
+            int32_t t   = (int32_t)(lfoPhase + TAP_PHASE[k]);
+            int32_t tri = ((t ^ (t >> 31)) >> 15) - 32768;   // triangle, -32768..32767
+            uint32_t d  = chorusBaseFP + tri * chorusDepth;  // 16.16 stages
+            sum += fromStage(lowpass8(interpolateRead(d), tapFilter[k]));
+        }
+        lfoPhase += lfoInc;
+
+        if (clockTick) {
+            buffer.push(toStage((int16_t)((input12 * 171) >> 8)));   // same headroom as process()
+        }
+
+        return (int16_t)((sum * TAP_GAIN[chorusTaps]) >> 16);
+    }
+
+    // Chorus taps (1-3) centred on baseSamples and swept ±depthSamples by a
+    // triangle LFO at rateMilliHz, each tap a third of a cycle from the next.
+    // The sweep is kept inside the line.
+    void setChorus(int taps, uint32_t baseSamples, uint32_t depthSamples, uint32_t rateMilliHz) {
+        if (taps < 1) taps = 1;
+        if (taps > CHORUS_TAPS) taps = CHORUS_TAPS;
+        if (baseSamples > getMaxDelaySamples() - 4) baseSamples = getMaxDelaySamples() - 4;
+        if (baseSamples < 4) baseSamples = 4;
+        if (depthSamples > baseSamples - 2) depthSamples = baseSamples - 2;
+        if (depthSamples > getMaxDelaySamples() - 4 - baseSamples) depthSamples = getMaxDelaySamples() - 4 - baseSamples;
+        if (depthSamples > 65535) depthSamples = 65535;   // × triangle ±32768 must fit int32
+        chorusTaps   = (uint8_t)taps;
+        chorusBaseFP = baseSamples << 15;
+        chorusDepth  = (int32_t)depthSamples;   // × triangle ±32768 = ± depth/2 stages in 16.16
+        lfoInc       = (uint32_t)(((uint64_t)rateMilliHz << 32) / 48000000u);
+    }
+
     // Set delay time in 48kHz samples
     void setDelaySamples(uint32_t samples) {
-        uint32_t maxSamples = (bufferSize * clockDivider);
-        if (samples > maxSamples) {
-            samples = maxSamples;
+        if constexpr (Clocked) {
+            if (samples > getMaxDelaySamples()) samples = getMaxDelaySamples();
+            if (samples < MaxStages) samples = MaxStages;
+            targetInc = (MaxStages << 16) / samples;
+            return;
+        }
+        if (samples > getMaxDelaySamples()) {
+            samples = getMaxDelaySamples();
         }
-        if (samples < clockDivider) {
-            samples = clockDivider;
+        if (samples < CLOCK_DIVIDER) {
+            samples = CLOCK_DIVIDER;
         }
-        targetDelaySamples = samples << 16;
+        targetDelayFP = samples << 15;   // ÷2 samples per stage, ×65536
     }
 
     // Set delay time in milliseconds
@@ -217,9 +401,9 @@ public:
         setDelaySamples(ms * 48);
     }
 
-    // Set interpolation speed
+    // Set interpolation speed, in 16.16 samples per sample
     void setSlewRate(uint16_t rate) {
-        delaySlewRate = rate;
+        delaySlewRate = rate >> 1;
     }
 
     // Set feedback amount (0-255)
@@ -241,29 +425,34 @@ public:
 
     // Clear buffer and reset state
     void clear() {
-        memset(buffer, 0, bufferSize);
-        writePos = 0;
+        clearStages();
         filterState = 0;
         clockCounter = 0;
+        clockPhase = 0;
+        antiAlias = recon[0] = recon[1] = 0;
+        heldStage = 0;
+        memset(tapFilter, 0, sizeof(tapFilter));
     }
 
     // Get maximum delay in 48kHz samples
-    uint32_t getMaxDelaySamples() const {
-        return bufferSize * clockDivider;
+    static constexpr uint32_t getMaxDelaySamples() {
+        return Clocked ? (MaxStages << 16) / MIN_CLOCK : MaxStages * CLOCK_DIVIDER;
     }
 
     // Get current delay in 48kHz samples
     uint32_t getCurrentDelaySamples() const {
-        return currentDelaySamples >> 16;
+        if constexpr (Clocked) return (MaxStages << 16) / clockInc;
+        return currentDelayFP >> 15;
     }
 
     // Get target delay in 48kHz samples
     uint32_t getTargetDelaySamples() const {
-        return targetDelaySamples >> 16;
+        if constexpr (Clocked) return (MaxStages << 16) / targetInc;
+        return targetDelayFP >> 15;
     }
 
     // Get current delay in milliseconds
     uint16_t getCurrentDelayMs() const {
-        return (currentDelaySamples >> 16) / 48;
+        return getCurrentDelaySamples() / 48;
     }
 };
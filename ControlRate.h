@@ -0,0 +1,106 @@
+#ifndef CONTROL_RATE_H
+#define CONTROL_RATE_H
+
+#include <stdint.h>
+
+// Control-rate parameter layer.
+//
+// Knobs and CV move slowly next to the 48 kHz sample clock, yet cards that
+// turn them into coefficients inside ProcessSample pay for the divides, table
+// lookups and 64-bit maths on every sample.  ControlClock divides the sample
+// clock down to a control rate; on each control tick the card feeds its raw
+// readings to ControlValues, which smooth them, apply hysteresis, and report
+// only real movement — so the code that derives coefficients runs only when
+// its input has changed.
+//
+//   ControlClock<48> control;    // 1 kHz
+//   ControlValue     knobX;
+//
+//   void ProcessSample() {
+//       if (control.tick())
+//           knobX.update(KnobVal(Knob::X), [this](int x) { patIdx = x * 31 / 4095; });
+//       ...
+//   }
+//
+// A ControlValue reports its first reading at once, so derived values are
+// set up on the first control tick.
+
+// Fires once every Divider samples (Divider = 48 is 1 kHz at 48 kHz)
+template <int Divider>
+class ControlClock {
+    int count;
+
+public:
+    static constexpr int DIVIDER = Divider;
+
+    ControlClock() : count(0) {}
+
+    // Call once per sample; true on the first call and every Divider after
+    inline bool tick() {
+        if (count == 0) {
+            count = Divider - 1;
+            return true;
+        }
+        count--;
+        return false;
+    }
+
+    // Make the next tick() fire, e.g. on entering a mode that needs fresh values
+    void reset() { count = 0; }
+};
+
+// One knob or CV reading at control rate.
+//
+// Readings go through a one-pole smoother (each update moves 1/2^smoothShift
+// of the way, in Q4), and the smoothed value is reported when it is at least
+// `hysteresis` away from the last reported value, or has reached either end
+// of lo..hi, so that a knob turned fully still reads exactly 0 or 4095.
+class ControlValue {
+    int32_t smoothQ4;
+    int16_t reported;
+    int16_t lo, hi;
+    uint8_t hysteresis;
+    uint8_t smoothShift;
+    bool    primed;
+
+public:
+    // Knob defaults; for CV (-2048..2047) pass lo/hi to match
+    ControlValue(int hysteresis = 8, int smoothShift = 2, int lo = 0, int hi = 4095)
+        : smoothQ4(0), reported(0), lo((int16_t)lo), hi((int16_t)hi),
+          hysteresis((uint8_t)hysteresis), smoothShift((uint8_t)smoothShift), primed(false) {}
+
+    // Feed a raw reading; true if the reported value changed
+    bool update(int raw) {
+        if (!primed) {
+            reset(raw);
+            return true;
+        }
+        smoothQ4 += (raw * 16 - smoothQ4) >> smoothShift;
+        int v = (smoothQ4 + 8) >> 4;
+        if (v == reported) return false;
+        int d = v - reported;
+        if (d < 0) d = -d;
+        if (d < hysteresis && v != lo && v != hi) return false;
+        reported = (int16_t)v;
+        return true;
+    }
+
+    // As above, calling onChange(value) when the reported value changes
+    template <class F>
+    bool update(int raw, F onChange) {
+        if (!update(raw)) return false;
+        onChange((int)reported);
+        return true;
+    }
+
+    // Jump straight to raw, without smoothing
+    void reset(int raw) {
+        smoothQ4 = raw * 16;
+        reported = (int16_t)raw;
+        primed   = true;
+    }
+
+    int value() const { return reported; }
+};
+
+#endif
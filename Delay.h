@@ -3,10 +3,91 @@
 
 #include <stdint.h>
 #include <string.h>
+#include "MuLawCodec.h"
+
+// Storage formats for the delay line.  Each holds 12-bit signed samples with
+// random access, in cells of cell_t:
+//   CELLS(n)          cells needed for n samples
+//   load(buf, i)      sample i
+//   store(buf, i, v)  set sample i; v is already clipped to 12 bits
+//
+//   Int16DelayStorage     2 bytes/sample, exact
+//   Packed12DelayStorage  1.5 bytes/sample, exact (two samples in three bytes)
+//   Int8DelayStorage      1 byte/sample, top 8 bits, truncated toward zero so
+//                         that decaying repeats reach silence rather than
+//                         sticking at an LSB
+//   MuLawDelayStorage     1 byte/sample, µ-law (MuLawCodec)
+struct Int16DelayStorage {
+    typedef int16_t cell_t;
+    static constexpr int CELLS(int n) { return n; }
+    static inline __attribute__((always_inline)) int32_t load(const cell_t* buf, int i) { return buf[i]; }
+    static inline __attribute__((always_inline)) void store(cell_t* buf, int i, int32_t v) { buf[i] = (int16_t)v; }
+};
+
+struct Packed12DelayStorage {
+    typedef uint8_t cell_t;
+    static constexpr int CELLS(int n) { return (n * 3 + 1) / 2; }
+    // Even sample: low byte in p[0], high nibble in the bottom of p[1].
+    // Odd sample: low nibble in the top of p[1], high byte in p[2].
+    static inline __attribute__((always_inline)) int32_t load(const cell_t* buf, int i) {
+        const uint8_t* p = buf + (i >> 1) * 3;
+        uint32_t u = (i & 1) ? (uint32_t)(p[1] >> 4) | ((uint32_t)p[2] << 4)
+                             : (uint32_t)p[0] | ((uint32_t)(p[1] & 0x0F) << 8);
+        return (int32_t)(u << 20) >> 20;
+    }
+    static inline __attribute__((always_inline)) void store(cell_t* buf, int i, int32_t v) {
+        uint8_t* p = buf + (i >> 1) * 3;
+        if (i & 1) {
+            p[1] = (uint8_t)((p[1] & 0x0F) | ((v & 0x0F) << 4));
+            p[2] = (uint8_t)(v >> 4);
+        } else {
+            p[0] = (uint8_t)v;
+            p[1] = (uint8_t)((p[1] & 0xF0) | ((v >> 8) & 0x0F));
+        }
+    }
+};
+
+struct Int8DelayStorage {
+    typedef int8_t cell_t;
+    static constexpr int CELLS(int n) { return n; }
+    static inline __attribute__((always_inline)) int32_t load(const cell_t* buf, int i) { return (int32_t)buf[i] * 16; }
+    static inline __attribute__((always_inline)) void store(cell_t* buf, int i, int32_t v) {
+        buf[i] = (int8_t)(v >= 0 ? v >> 4 : -(-v >> 4));
+    }
+};
+
+struct MuLawDelayStorage {
+    typedef uint8_t cell_t;
+    static constexpr int CELLS(int n) { return n; }
+    static inline __attribute__((always_inline)) int32_t load(const cell_t* buf, int i) { return MuLawCodec::decodeSample(buf[i]); }
+    static inline __attribute__((always_inline)) void store(cell_t* buf, int i, int32_t v) { buf[i] = MuLawCodec::encodeSample((int16_t)v); }
+};
+
+// Equal-power crossfade gains for Delay's Crossfade mode, in Q15: with j of
+// STEPS steps left, v[j][0] = sin(j/STEPS · π/2) for the head fading out and
+// v[j][1] = cos(j/STEPS · π/2) for the one fading in, side by side so a sample
+// of the fade looks its gains up once.  Filled in by the compiler.
+struct DelayCrossfadeTable {
+    static constexpr int STEPS = 256;
+    int16_t v[STEPS + 1][2];
+    constexpr DelayCrossfadeTable() : v() {
+        for (int k = 0; k <= STEPS; k++) {
+            // Taylor series, to x^15: well under an LSB over 0..π/2
+            double x = 1.5707963267948966 * k / STEPS, term = x, s = x;
+            for (int n = 1; n < 8; n++) {
+                term *= -x * x / ((2 * n) * (2 * n + 1));
+                s += term;
+            }
+            v[k][0]         = (int16_t)(s * 32767.0 + 0.5);
+            v[STEPS - k][1] = v[k][0];
+        }
+    }
+};
+inline constexpr DelayCrossfadeTable delayCrossfadeTable{};
 
 // Tape-style mono delay with LP-filtered feedback and interpolated time changes.
 //
-// Y knob (0-4095): delay time 50 ms → 750 ms
+// Y knob (0-4095): delay time 50 ms → MaxSamples (750 ms by default)
 // Feedback fixed at 0.65 (~5 audible repeats, each progressively darker).
 //
 // Input is scaled by INPUT_GAIN (-6 dB) before entering the feedback loop so
@@ -17,53 +98,99 @@
 // sample (Q8 fixed-point).  Linear interpolation between adjacent buffer
 // samples gives a smooth pitch-bend rather than a click during the transition.
 //
-// Delay buffer RAM: 36 000 × int16 = 72 KB
-// (Delay is limited to 750 ms to keep total static RAM within bounds:
-//  144 KB sample buffer + 72 KB delay = 216 KB, leaving room for the USB host stack.)
+// Delay buffer RAM is Storage::CELLS(MaxSamples) cells, e.g. for 750 ms:
+//   Int16DelayStorage 72 KB, Packed12DelayStorage 54 KB,
+//   Int8DelayStorage / MuLawDelayStorage 36 KB
+// and for 1.5 s, 72 KB with either of the 8-bit formats.  The 8-bit formats
+// requantise every repeat; µ-law keeps quiet tails clean, 8-bit linear is
+// cheaper but hisses on them.
+//
+// Crossfade: a jump in delay time of more than XFADE_MIN_Q8 (1 ms) no longer
+// slews.  A second read head starts at the new time and the two are
+// equal-power crossfaded over XFADE_SAMPLES (~10.7 ms), so the new time takes
+// effect at once with no pitch bend.  Both heads read whole samples, so a
+// fade costs one more multiply, and a lookup of its gain pair, than an
+// interpolated read.  Smaller changes still slew.  A new target arriving
+// mid-fade waits for the fade to finish.  A fade is only looked for once the
+// target has moved off the current delay, so with the knob still this mode
+// costs the same as the default one.
 
+template <int MaxSamples = 36000, class Storage = Int16DelayStorage, bool Crossfade = false>
 class Delay {
-    static constexpr int MAX_SAMPLES = 36000;   // 750 ms at 48 kHz
+    static constexpr int MAX_SAMPLES = MaxSamples;
+    static constexpr int MIN_SAMPLES = 2400;     // 50 ms at 48 kHz
+    static_assert(MAX_SAMPLES > MIN_SAMPLES && MAX_SAMPLES <= (1 << 19), "delay length out of range");
 
-    int16_t buf[MAX_SAMPLES];
+    typedef typename Storage::cell_t cell_t;
+    cell_t  buf[Storage::CELLS(MAX_SAMPLES)];
     int     writeIdx;
     int32_t lpState;          // one-pole LP state in feedback path
-    int32_t currentDelayQ8;   // current delay in Q8 (samples × 256)
+    int32_t currentDelayQ8;   // current delay in Q8 (samples × 256), FADING during a fade
+    int     fadeFrom, fadeTo; // Crossfade: whole-sample delays of the heads fading out and in
+    int     fadeLeft;         // Crossfade: samples left in the fade, 0 if none
 
     static constexpr int32_t FEEDBACK   = 21299;  // 0.65 in Q15
     static constexpr int32_t LP_COEF    = 13107;  // 0.40 in Q15
     static constexpr int32_t INPUT_GAIN = 16384;  // 0.50 in Q15 (-6 dB)
     // Slew: 512 Q8-units/sample = 2 samples/sample → ~350 ms to sweep full range.
     static constexpr int32_t SLEW_Q8  = 512;
+    // Crossfade: STEPS gain steps of 2 samples each
+    static constexpr int     XFADE_SHIFT   = 1;
+    static constexpr int     XFADE_SAMPLES = DelayCrossfadeTable::STEPS << XFADE_SHIFT;
+    static constexpr int32_t XFADE_MIN_Q8  = 48 << 8;
+    // currentDelayQ8 while fading: never a target, so a fade is never settled
+    static constexpr int32_t FADING        = -1;
 
 public:
-    Delay() : writeIdx(0), lpState(0), currentDelayQ8(2400 << 8) {
-        memset(buf, 0, sizeof(buf));
+    Delay() : writeIdx(0), lpState(0), currentDelayQ8(MIN_SAMPLES << 8), fadeFrom(0), fadeTo(0), fadeLeft(0) {
+        for (int i = 0; i < MAX_SAMPLES; i++) Storage::store(buf, i, 0);
+    }
+
+    // Delay time in samples for a knob position (0-4095), MIN_SAMPLES to
+    // just under MAX_SAMPLES
+    static inline int samplesForKnob(int knobY)
+    {
+        return MIN_SAMPLES + (int)(((int32_t)knobY * (MAX_SAMPLES - MIN_SAMPLES)) >> 12);
     }
 
     // input: 12-bit signed; returns 12-bit signed wet output.
     // knobY: 0-4095
     int16_t __attribute__((section(".time_critical.DelayProcess"))) process(int16_t input, int knobY)
     {
-        // Target delay in Q8
-        int32_t targetQ8 = (2400 + (((int32_t)knobY * 33600) >> 12)) << 8;
-
-        // Slew currentDelay toward target
+        int32_t targetQ8 = targetDelayQ8(knobY);
         int32_t diff = targetQ8 - currentDelayQ8;
-        if      (diff >  SLEW_Q8) currentDelayQ8 += SLEW_Q8;
-        else if (diff < -SLEW_Q8) currentDelayQ8 -= SLEW_Q8;
-        else                      currentDelayQ8   = targetQ8;
+        int32_t delayed;
+
+        if (Crossfade && diff != 0 && (fadeLeft || diff > XFADE_MIN_Q8 || diff < -XFADE_MIN_Q8)) {
+            if (!fadeLeft) {
+                // Start a fade; one starting mid-slew rounds the old head
+                // to the nearest whole sample
+                fadeFrom       = (currentDelayQ8 + 128) >> 8;
+                fadeTo         = targetQ8 >> 8;
+                fadeLeft       = XFADE_SAMPLES;
+                currentDelayQ8 = FADING;
+            }
+            delayed = crossfadeRead();
+        } else {
+            // Slew currentDelay toward target
+            if (diff != 0) {
+                if      (diff >  SLEW_Q8) currentDelayQ8 += SLEW_Q8;
+                else if (diff < -SLEW_Q8) currentDelayQ8 -= SLEW_Q8;
+                else                      currentDelayQ8   = targetQ8;
+            }
 
-        // Fractional read position in Q8
-        int32_t readPosQ8 = (writeIdx << 8) - currentDelayQ8;
-        if (readPosQ8 < 0) readPosQ8 += (MAX_SAMPLES << 8);
+            // Fractional read position in Q8
+            int32_t readPosQ8 = (writeIdx << 8) - currentDelayQ8;
+            if (readPosQ8 < 0) readPosQ8 += (MAX_SAMPLES << 8);
 
-        int r0   = (readPosQ8 >> 8);
-        int r1   = (r0 + 1 < MAX_SAMPLES) ? r0 + 1 : 0;
-        int frac = readPosQ8 & 0xFF;   // 0-255
+            int r0   = (readPosQ8 >> 8);
+            int r1   = (r0 + 1 < MAX_SAMPLES) ? r0 + 1 : 0;
+            int frac = readPosQ8 & 0xFF;   // 0-255
 
-        // Linear interpolation between adjacent samples
-        int32_t delayed = (int32_t)buf[r0] +
-                          (((int32_t)(buf[r1] - buf[r0]) * frac) >> 8);
+            // Linear interpolation between adjacent samples
+            int32_t a = Storage::load(buf, r0);
+            delayed = a + (((Storage::load(buf, r1) - a) * frac) >> 8);
+        }
 
         // One-pole LP on the feedback path: warms each successive repeat
         lpState += (LP_COEF * (delayed - lpState)) >> 15;
@@ -73,7 +200,7 @@ public:
                   + ((FEEDBACK * lpState) >> 15);
         if (w >  2047) w =  2047;
         if (w < -2048) w = -2048;
-        buf[writeIdx] = (int16_t)w;
+        Storage::store(buf, writeIdx, w);
 
         if (++writeIdx >= MAX_SAMPLES) writeIdx = 0;
 
@@ -82,6 +209,89 @@ public:
         if (delayed < -2048) delayed = -2048;
         return (int16_t)delayed;
     }
+
+    // Block version of process(): n samples from in[] to out[] (which may be
+    // the same buffer), with knobY read once for the block.  Output is
+    // identical to calling process() n times with the same knobY.
+    //
+    // While the delay time is slewing or crossfading the read position moves
+    // every sample, so those samples go through process().  Once it has settled the read
+    // and write positions advance together: the rest of the block is split
+    // into spans where neither wraps, and each span runs a branch-free loop.
+    void __attribute__((section(".time_critical.DelayProcessBlock"))) processBlock(const int16_t* in, int16_t* out, int n, int knobY)
+    {
+        int32_t targetQ8 = targetDelayQ8(knobY);
+        while (n > 0 && currentDelayQ8 != targetQ8) {
+            *out++ = process(*in++, knobY);
+            n--;
+        }
+
+        // Read position = writeIdx - ceil(delay), frac fixed for the block
+        const int32_t frac  = (-currentDelayQ8) & 0xFF;
+        const int     whole = (currentDelayQ8 + 255) >> 8;
+        int32_t lp = lpState;
+
+        while (n > 0) {
+            int r0 = writeIdx - whole;
+            if (r0 < 0) r0 += MAX_SAMPLES;
+
+            // Span ends before writeIdx wraps, or r0 + 1 would
+            int span = n;
+            if (span > MAX_SAMPLES - writeIdx) span = MAX_SAMPLES - writeIdx;
+            if (span > MAX_SAMPLES - 1 - r0)   span = MAX_SAMPLES - 1 - r0;
+            if (span == 0) {
+                // r0 is the last slot and r1 wraps to 0: one sample the long way
+                lpState = lp;
+                *out++ = process(*in++, knobY);
+                lp = lpState;
+                n--;
+                continue;
+            }
+
+            const int wi = writeIdx;
+            for (int i = 0; i < span; i++) {
+                int32_t a = Storage::load(buf, r0 + i);
+                int32_t delayed = a + (((Storage::load(buf, r0 + i + 1) - a) * frac) >> 8);
+                lp += (LP_COEF * (delayed - lp)) >> 15;
+                int32_t w = (((int32_t)in[i] * INPUT_GAIN) >> 15)
+                          + ((FEEDBACK * lp) >> 15);
+                if (w >  2047) w =  2047;
+                if (w < -2048) w = -2048;
+                Storage::store(buf, wi + i, w);
+                if (delayed >  2047) delayed =  2047;
+                if (delayed < -2048) delayed = -2048;
+                out[i] = (int16_t)delayed;
+            }
+
+            writeIdx += span;
+            if (writeIdx >= MAX_SAMPLES) writeIdx = 0;
+            in  += span;
+            out += span;
+            n   -= span;
+        }
+        lpState = lp;
+    }
+
+private:
+    // Crossfade mode's read: the head at fadeFrom fades out as one at fadeTo
+    // fades in, then takes its place
+    inline __attribute__((always_inline)) int32_t crossfadeRead()
+    {
+        int rOld = writeIdx - fadeFrom;
+        int rNew = writeIdx - fadeTo;
+        if (rOld < 0) rOld += MAX_SAMPLES;
+        if (rNew < 0) rNew += MAX_SAMPLES;
+
+        const int16_t* g = delayCrossfadeTable.v[(fadeLeft + 1) >> XFADE_SHIFT];
+        int32_t y = (Storage::load(buf, rOld) * g[0] + Storage::load(buf, rNew) * g[1]) >> 15;
+        if (--fadeLeft == 0) currentDelayQ8 = fadeTo << 8;
+        return y;
+    }
+
+    static inline int32_t targetDelayQ8(int knobY)
+    {
+        return samplesForKnob(knobY) << 8;
+    }
 };
 
 #endif
@@ -0,0 +1,109 @@
+#ifndef FDN_REVERB_H
+#define FDN_REVERB_H
+
+#include <stdint.h>
+#include <string.h>
+#include "RingBuffer.h"
+
+// Feedback-delay-network reverb: 8 delay lines, mixed by a Householder
+// matrix and fed back through a per-line LP and a common decay gain.
+// Same interface as Reverb, as an alternative to it: every echo is fed to
+// every line, so echo density builds up far faster than in the parallel
+// combs, and the tail does not ring at one comb's pitch at high feedback.
+//
+// The mixing matrix is the 8×8 Householder reflection I - (2/8)·11ᵀ.  It
+// is orthogonal (the network is lossless before decay and damping), and
+// applying it takes one sum and a shift — no multiplies.
+//
+// knobY (0-4095) drives both parameters, as in Reverb:
+//   decay    – Q15 gain per pass, 0.60 at Y=0 → 0.97 at Y=4095
+//   damping  – one-pole LP per line, 0.10 → 0.65 (higher = darker)
+//
+// Lines hold samples ×4 (two fractional bits below the 12-bit signal), so
+// the quiet end of the tail is not lost to truncation.  The decay gain
+// truncates toward zero, so every pass shrinks the state and the tail
+// decays to silence rather than sitting in a limit cycle.
+//
+// Line lengths 557-1013 samples (11.6-21.1 ms), mutually prime, in a
+// shared 1024-frame ring: 16 KB of RAM.
+
+class FdnReverb {
+    static constexpr int LINES = 8;
+    static constexpr int LEN[LINES] = { 557, 613, 691, 757, 829, 887, 953, 1013 };
+
+    // The lines advance together, so they share one ring of frames: frame
+    // f holds what was written to every line at time f, and line i reads
+    // v[i] of the frame LEN[i] back.  One write index, one frame store.
+    struct Frame { int16_t v[LINES]; };
+    RingBuffer<Frame, 10> lines;
+    int32_t lp[LINES];    // per-line LP state, ×4
+
+    static constexpr int32_t INPUT_GAIN = 8192;   // 0.25 in Q15, into each line
+    static constexpr int32_t ROUND      = 1 << 14;
+
+public:
+    FdnReverb() {
+        memset(lp, 0, sizeof(lp));
+    }
+
+    // Process one 12-bit signed sample; returns 12-bit signed wet output.
+    // knobY: 0-4095
+    int16_t __attribute__((section(".time_critical.FdnReverbProcess"))) process(int16_t input, int knobY)
+    {
+        const int32_t g    = decayQ15(knobY);
+        const int32_t damp = dampingQ15(knobY);
+
+        // Read and damp every line; the output taps the lines undamped, with
+        // alternating signs so they do not all add in phase
+        int32_t x[LINES];
+        int32_t sum = 0, out = 0;
+        for (int i = 0; i < LINES; i++) {
+            int32_t d = lines.at(lines.tapPos(LEN[i])).v[i];
+            lp[i] += ((d - lp[i]) * (32768 - damp) + ROUND) >> 15;
+            x[i] = lp[i];
+            sum += lp[i];
+            out += (i & 1) ? -d : d;
+        }
+
+        // Householder mix, decay, and the input in with a sign pattern
+        // orthogonal to the output's
+        const int32_t s  = sum >> 2;
+        const int32_t in = ((int32_t)input * 4 * INPUT_GAIN + ROUND) >> 15;
+        Frame f;
+        for (int i = 0; i < LINES; i++) {
+            // x - s reaches about ±81920 with the lines clamped; held to
+            // ±65535 so that times g (under 2^15) it fits 32 bits
+            int32_t e = x[i] - s;
+            if (e >  65535) e =  65535;
+            if (e < -65535) e = -65535;
+            int32_t v = e * g;
+            v += (v >> 31) & 0x7FFF;    // so that >> 15 truncates toward zero
+            int32_t w = (v >> 15) + ((i & 2) ? -in : in);
+            if (w >  32767) w =  32767;
+            if (w < -32768) w = -32768;
+            f.v[i] = (int16_t)w;
+        }
+        lines.push(f);
+
+        // ÷4 for the fractional bits, ÷4 for eight lines adding ~2.8× in amplitude
+        out = (out + 8) >> 4;
+        if (out >  2047) out =  2047;
+        if (out < -2048) out = -2048;
+        return (int16_t)out;
+    }
+
+private:
+    // decay Q15: 0.60 (19661) at Y=0  →  0.97 (31785) at Y=4095
+    static inline int32_t decayQ15(int knobY)
+    {
+        return 19661 + (((int32_t)knobY * 12124) >> 12);
+    }
+
+    // damping Q15: 0.10 (3277)  at Y=0  →  0.65 (21299) at Y=4095
+    static inline int32_t dampingQ15(int knobY)
+    {
+        return 3277 + (((int32_t)knobY * 18022) >> 12);
+    }
+};
+
+#endif
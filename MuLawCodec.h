@@ -12,36 +12,102 @@
 //
 // This gives true µ-law character: fine quantisation on quiet signals,
 // coarse on loud — without the distortion of the old 3-segment version.
+//
+// Both lookup tables are generated at compile time and live in flash
+// (.rodata), so a MuLawCodec takes no RAM and no start-up work.  The encode
+// table (4 KB) is only used when recording; the decode table (512 bytes) is
+// read by every voice on every sample, and flash reads can miss the XIP
+// cache.  To keep it in SRAM instead, define MULAW_DECODE_SECTION, e.g.
+//
+//   target_compile_definitions(card PRIVATE MULAW_DECODE_SECTION=".scratch_x.mulaw")
+//
+// .scratch_x / .scratch_y are the 4 KB per-core banks (core 1's stack lives
+// at the top of scratch_x); ".time_critical.mulaw" puts it in main SRAM.
+// crt0 copies it into place along with .data; nothing runs at boot.
+
+#ifdef MULAW_DECODE_SECTION
+#define MULAW_DECODE_ATTR __attribute__((section(MULAW_DECODE_SECTION)))
+#else
+#define MULAW_DECODE_ATTR
+#endif
 
 class MuLawCodec {
     // G.711 constants
     static constexpr int32_t BIAS  = 132;   // 0x84
     static constexpr int32_t SCALE = 4;     // 12-bit → 13-bit
 
-    // Lookup tables built once in the constructor
-    uint8_t  encodeTable[4096];   // index = sample + 2048  (0-4095)
-    int16_t  decodeTable[256];
+    // 32-bit view of the byte buffers used by the block functions
+    typedef uint32_t __attribute__((__may_alias__)) word_t;
+
+    // Lookup tables, filled in by the compiler (see definitions below the class)
+    struct EncodeTable {
+        uint8_t v[4096];   // index = sample + 2048  (0-4095)
+        constexpr EncodeTable() : v() {
+            for (int i = 0; i < 4096; i++) v[i] = encode((int16_t)(i - 2048));
+        }
+    };
+    struct DecodeTable {
+        int16_t v[256];
+        constexpr DecodeTable() : v() {
+            for (int i = 0; i < 256; i++) v[i] = decode((uint8_t)i);
+        }
+    };
+    static const EncodeTable encodeTable;
+    static const DecodeTable decodeTable;
 
 public:
-    MuLawCodec() {
-        for (int i = 0; i < 4096; i++)
-            encodeTable[i] = encode((int16_t)(i - 2048));
-        for (int i = 0; i < 256; i++)
-            decodeTable[i] = decode((uint8_t)i);
-    }
-
     // Encode a 12-bit signed sample to 8-bit µ-law
-    inline __attribute__((always_inline)) uint8_t encodeSample(int16_t input) {
-        return encodeTable[(uint16_t)(input + 2048) & 0xFFF];
+    static inline __attribute__((always_inline)) uint8_t encodeSample(int16_t input) {
+        return encodeTable.v[(uint16_t)(input + 2048) & 0xFFF];
     }
 
     // Decode 8-bit µ-law back to 12-bit signed
-    inline __attribute__((always_inline)) int16_t decodeSample(uint8_t mulaw) {
-        return decodeTable[mulaw];
+    static inline __attribute__((always_inline)) int16_t decodeSample(uint8_t mulaw) {
+        return decodeTable.v[mulaw];
+    }
+
+    // Block versions of the above for bulk conversion.  The µ-law side is
+    // accessed a 32-bit word (4 samples) at a time once it is word-aligned,
+    // which saves three of every four byte loads/stores on the M0+.  Bytes are
+    // unpacked little-endian, as on the RP2040.  Output is identical to
+    // calling encodeSample/decodeSample per sample.
+    static void encodeBlock(const int16_t* in, uint8_t* out, int n) {
+        // Head: byte stores until out is word-aligned
+        while (n > 0 && ((uintptr_t)out & 3)) {
+            *out++ = encodeSample(*in++);
+            n--;
+        }
+        word_t* w = (word_t*)out;
+        for (; n >= 4; n -= 4, in += 4) {
+            *w++ =  (uint32_t)encodeSample(in[0])
+                 | ((uint32_t)encodeSample(in[1]) << 8)
+                 | ((uint32_t)encodeSample(in[2]) << 16)
+                 | ((uint32_t)encodeSample(in[3]) << 24);
+        }
+        out = (uint8_t*)w;
+        while (n-- > 0) *out++ = encodeSample(*in++);
+    }
+
+    static void decodeBlock(const uint8_t* in, int16_t* out, int n) {
+        // Head: byte loads until in is word-aligned
+        while (n > 0 && ((uintptr_t)in & 3)) {
+            *out++ = decodeSample(*in++);
+            n--;
+        }
+        const word_t* w = (const word_t*)in;
+        for (; n >= 4; n -= 4, out += 4) {
+            uint32_t q = *w++;
+            out[0] = decodeTable.v[q & 0xFF];
+            out[1] = decodeTable.v[(q >> 8) & 0xFF];
+            out[2] = decodeTable.v[(q >> 16) & 0xFF];
+            out[3] = decodeTable.v[q >> 24];
+        }
+        in = (const uint8_t*)w;
+        while (n-- > 0) *out++ = decodeSample(*in++);
     }
 
 private:
-    uint8_t encode(int16_t sample) {
+    static constexpr uint8_t encode(int16_t sample) {
         // Sign: bit 7 set = positive (G.711 convention)
         uint8_t sign = (sample >= 0) ? 0x80u : 0x00u;
         if (sample < 0) sample = -sample;
@@ -60,7 +126,7 @@ private:
         return (uint8_t)~(sign | (segment << 4) | mantissa);
     }
 
-    int16_t decode(uint8_t mulaw) {
+    static constexpr int16_t decode(uint8_t mulaw) {
         uint8_t u        = ~mulaw;
         uint8_t sign     = u & 0x80;
         uint8_t segment  = (u >> 4) & 0x07;
@@ -79,4 +145,7 @@ private:
     }
 };
 
+inline constexpr MuLawCodec::EncodeTable MuLawCodec::encodeTable{};
+MULAW_DECODE_ATTR inline constexpr MuLawCodec::DecodeTable MuLawCodec::decodeTable{};
+
 #endif
@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include <string.h>
+#include "RingBuffer.h"
 
 // Schroeder/Freeverb-style reverb: 4 LP-damped comb filters + 2 allpass filters.
 // All arithmetic is Q15 fixed-point integer – no floats at runtime.
@@ -11,90 +12,400 @@
 //   feedback – higher Y = longer tail
 //   damping  – higher Y = more HF rolloff per reflection = darker sound
 //
-// Total delay-line RAM: ~13.4 KB
+// Rate is the rate the filter network runs at; process() is always called
+// at 48 kHz.
+//   Reverb<>       48 kHz.  Delay lines are power-of-two rings (RingBuffer),
+//                  so each is rounded up: 4 × 2048 + 1024 + 512 samples, ~19 KB.
+//   Reverb<24000>  24 kHz: the input is low-passed ([1 2 1]/4) and every other
+//                  sample goes through the network, and the output is linearly
+//                  interpolated back up.  Half the filter work and half the RAM
+//                  (4 × 1024 + 512 + 256 samples, ~9.5 KB); the tail has no
+//                  top octave and comes out 2 samples later.
+//                  The same knob gives the same decay time and damping cutoff.
+//
+// Modulated = true slowly sweeps the read taps of the longest comb and the
+// first allpass, ±0.25 ms from one shared 0.7 Hz triangle LFO (the two in
+// quadrature), reading between samples with tapQ8.  This breaks up the
+// fixed comb resonances that make long tails on sustained pads sound
+// metallic, for the cost of two interpolated reads and an LFO step per
+// tick; the rest of the network is unchanged.
+//
+// Stereo = true adds processStereo(), a decorrelated pair from the one comb
+// bank: right sums the combs with alternating signs and diffuses them
+// through its own two allpasses, Freeverb's stereo spread (23 samples at
+// 44.1 kHz) longer than the left ones.  That costs those two allpasses and
+// their rings (+1024 + 512 samples at 48 kHz, +512 + 256 at 24 kHz, so
+// ~22 KB and ~11 KB in all), not a second comb bank; without Stereo the
+// rings are one-slot placeholders.
+//
+// setFreeze(true) holds the tail indefinitely: the combs run at unity
+// feedback with no damping, which also mutes the input, since it is scaled
+// by 1 - feedback.  With Modulated the swept comb's interpolation still
+// loses a little top end, so a frozen tail slowly darkens.
 
+template <int Rate = 48000, bool Modulated = false, bool Stereo = false>
 class Reverb {
-    // Delay lengths in samples at 48 kHz (Freeverb ratios scaled from 44.1 kHz)
-    static constexpr int C0 = 1214, C1 = 1389, C2 = 1547, C3 = 1693;
-    static constexpr int A0 =  605, A1 =  371;
+    static_assert(Rate == 48000 || Rate == 24000, "Reverb runs at 48 or 24 kHz");
+    static constexpr bool HALF_RATE = (Rate == 24000);
+
+    // Delay lengths in samples at Rate (Freeverb's 44.1 kHz lengths, scaled)
+    static constexpr int atRate(int len44k) { return (int)((int64_t)len44k * Rate / 44100); }
+    static constexpr int C0 = atRate(1116), C1 = atRate(1277), C2 = atRate(1422), C3 = atRate(1556);
+    static constexpr int A0 = atRate(556),  A1 = atRate(341);
+    static constexpr int A0R = atRate(556 + 23), A1R = atRate(341 + 23);   // right channel
 
-    int16_t cBuf0[C0], cBuf1[C1], cBuf2[C2], cBuf3[C3];
-    int16_t aBuf0[A0], aBuf1[A1];
+    // log2 of the smallest power of two above len
+    static constexpr int ringBits(int len) { int b = 0; while ((1 << b) <= len) b++; return b; }
+
+    typedef RingBuffer<int16_t, ringBits(C3)> CombLine;   // C0 < C1 < C2 < C3
+    typedef RingBuffer<int16_t, ringBits(A0)> Allpass0;
+    typedef RingBuffer<int16_t, Stereo ? ringBits(A0R) : 0> Allpass0R;
+    typedef RingBuffer<int16_t, Stereo ? ringBits(A1R) : 0> Allpass1R;
+    CombLine cBuf0, cBuf1, cBuf2, cBuf3;
+    Allpass0 aBuf0;
+    RingBuffer<int16_t, ringBits(A1)> aBuf1;
+    Allpass0R aBufR0;
+    Allpass1R aBufR1;
     int32_t cLp[4];   // one-pole LP state per comb (stays in audio range)
-    int     cIdx[4];
-    int     aIdx[2];
+
+    // Half rate only: input low-pass history, the last two network outputs
+    // (left and right), and which of the pair of 48 kHz samples is next
+    int16_t x1, x2;
+    int16_t yPrev, yCur;
+    int16_t yPrevR, yCurR;
+    bool    phase;
+
+    bool    frozen;
+
+    // Modulated only: LFO phase (one full triangle per 2^32), and the
+    // Q8 offset it gives a tap for a sweep of ±MOD_DEPTH samples
+    uint32_t lfoPhase;
+    static constexpr int32_t  MOD_DEPTH = Rate / 4000;      // 0.25 ms
+    static constexpr uint32_t LFO_INC   = (uint32_t)(4294967296.0 * 0.7 / Rate);
+    static constexpr uint32_t QUADRATURE = 1u << 30;
+    static_assert(C3 + MOD_DEPTH + 1 < CombLine::SIZE && A0 + MOD_DEPTH + 1 < Allpass0::SIZE &&
+                  (!Stereo || A0R + MOD_DEPTH + 1 < Allpass0R::SIZE),
+                  "modulated taps must stay inside their rings");
 
     static constexpr int32_t AP_GAIN = 16384;  // allpass feedback = 0.5 in Q15
 
 public:
-    Reverb() {
-        memset(cBuf0, 0, sizeof(cBuf0)); memset(cBuf1, 0, sizeof(cBuf1));
-        memset(cBuf2, 0, sizeof(cBuf2)); memset(cBuf3, 0, sizeof(cBuf3));
-        memset(aBuf0, 0, sizeof(aBuf0)); memset(aBuf1, 0, sizeof(aBuf1));
-        memset(cLp,   0, sizeof(cLp));
-        memset(cIdx,  0, sizeof(cIdx));
-        memset(aIdx,  0, sizeof(aIdx));
+    Reverb() : x1(0), x2(0), yPrev(0), yCur(0), yPrevR(0), yCurR(0), phase(false),
+               frozen(false), lfoPhase(0) {
+        memset(cLp, 0, sizeof(cLp));
     }
 
+    // Hold the current tail (true) or let it decay and take input again (false)
+    void setFreeze(bool on) { frozen = on; }
+    bool isFrozen() const { return frozen; }
+
     // Process one 12-bit signed sample; returns 12-bit signed wet output.
     // knobY: 0-4095
     int16_t process(int16_t input, int knobY)
     {
-        // feedback Q15: 0.50 (16384) at Y=0  →  0.95 (31130) at Y=4095
-        int32_t fb   = 16384 + ((int32_t)knobY * 14746) / 4096;
-        // damping Q15: 0.10 (3277)  at Y=0  →  0.65 (21299) at Y=4095
-        //   higher = more HF rolloff per reflection = darker tail
-        int32_t damp = 3277  + ((int32_t)knobY * 18022) / 4096;
+        return step(input, feedback(knobY), damping(knobY));
+    }
+
+    // As process(), with a second, decorrelated output from the same combs.
+    // left is exactly what process() would return.
+    void processStereo(int16_t input, int knobY, int16_t& left, int16_t& right)
+    {
+        static_assert(Stereo, "processStereo needs Reverb<Rate, Modulated, true>");
+        if (!HALF_RATE) {
+            left = tick(input, feedback(knobY), damping(knobY), &right);
+            return;
+        }
+
+        int32_t lpIn = (x2 + 2 * x1 + input) >> 2;
+        x2 = x1;
+        x1 = input;
+        phase = !phase;
+        if (phase) {
+            yPrev  = yCur;
+            yPrevR = yCurR;
+            yCur   = tick(lpIn, feedback(knobY), damping(knobY), &yCurR);
+            left   = yPrev;
+            right  = yPrevR;
+            return;
+        }
+        left  = (int16_t)((yPrev + yCur) >> 1);
+        right = (int16_t)((yPrevR + yCurR) >> 1);
+    }
+
+    // Block version of process(): n samples from in[] to out[] (which may be
+    // the same buffer), with knobY read once for the block.  Output is
+    // identical to calling process() n times with the same knobY.
+    //
+    // It is for callers that already work in blocks, as vss runs Delay: a
+    // block of samples buffered in the ISR, the knob read once for it.  It is
+    // not a speedup.  On the host it measures level with process(), 0.87x to
+    // 1.21x across block sizes and rates, which is within run-to-run noise;
+    // it has not been timed on the M0+.
+    //
+    // The whole network runs a sample at a time as in process(), but over
+    // stretches where no line's read or write position wraps: each line is
+    // then a pair of plain pointers, and the LP states and parameters stay in
+    // locals.  At 24 kHz each network sample takes a pair of input samples
+    // and gives a pair of output samples, so the decimation and
+    // interpolation run in the same loop.
+    void __attribute__((section(".time_critical.ReverbProcessBlock"))) processBlock(const int16_t* in, int16_t* out, int n, int knobY)
+    {
+        const int32_t fb   = feedback(knobY);
+        const int32_t damp = damping(knobY);
+
+        if (!HALF_RATE) {
+            FullRateIo io = { in, out };
+            network(io, n, fb, damp);
+            return;
+        }
+
+        // Pairs start on the sample that ticks the network; an odd sample
+        // either end goes through step()
+        if (phase && n > 0) {
+            *out++ = step(*in++, fb, damp);
+            n--;
+        }
+        HalfRateIo io = { in, out, x1, x2, yPrev, yCur };
+        network(io, n >> 1, fb, halfRateDamping(damp));
+        x1    = (int16_t)io.x1;
+        x2    = (int16_t)io.x2;
+        yPrev = (int16_t)io.yPrev;
+        yCur  = (int16_t)io.yCur;
+        if (n & 1) out[n - 1] = step(in[n - 1], fb, damp);
+    }
+
+private:
+    // feedback Q15: 0.50 (16384) at Y=0  →  0.95 (31130) at Y=4095
+    static inline int32_t feedbackQ15(int knobY)
+    {
+        return 16384 + ((int32_t)knobY * 14746) / 4096;
+    }
+
+    // damping Q15: 0.10 (3277)  at Y=0  →  0.65 (21299) at Y=4095
+    //   higher = more HF rolloff per reflection = darker tail
+    static inline int32_t dampingQ15(int knobY)
+    {
+        return 3277 + ((int32_t)knobY * 18022) / 4096;
+    }
+
+    // The parameters the network runs with: the knob's, or lossless when frozen
+    inline int32_t feedback(int knobY) const { return frozen ? 32768 : feedbackQ15(knobY); }
+    inline int32_t damping(int knobY)  const { return frozen ? 0 : dampingQ15(knobY); }
+
+    // A one-pole with pole d at 48 kHz has pole d² at 24 kHz
+    static inline int32_t halfRateDamping(int32_t damp)
+    {
+        return (damp * damp) >> 15;
+    }
+
+    // process() with the parameters worked out: one 48 kHz sample
+    int16_t step(int16_t input, int32_t fb, int32_t damp)
+    {
+        if (!HALF_RATE) return tick(input, fb, damp);
+
+        int32_t lpIn = (x2 + 2 * x1 + input) >> 2;
+        x2 = x1;
+        x1 = input;
+        phase = !phase;
+        if (phase) {
+            yPrev = yCur;
+            yCur  = tick(lpIn, fb, damp);
+            return yPrev;
+        }
+        return (int16_t)((yPrev + yCur) >> 1);
+    }
+
+    // One sample through the network, at Rate; with right given, the right
+    // channel as well
+    int16_t tick(int32_t input, int32_t fb, int32_t damp, int16_t* right = nullptr)
+    {
+        if (HALF_RATE) damp = halfRateDamping(damp);
 
         // Pre-attenuate input by (1-fb) to normalise the comb DC gain (= 1/(1-fb))
         // back to unity.  Without this, high feedback causes the comb buffers to
         // accumulate to ~20× the input amplitude and saturate hard.
-        int32_t normIn = ((32768 - fb) * (int32_t)input) >> 15;
+        int32_t normIn = ((32768 - fb) * input) >> 15;
 
         // 4 comb filters in parallel, then sum
-        int32_t wet = 0;
-        wet += processComb(cBuf0, C0, cIdx[0], cLp[0], normIn, fb, damp);
-        wet += processComb(cBuf1, C1, cIdx[1], cLp[1], normIn, fb, damp);
-        wet += processComb(cBuf2, C2, cIdx[2], cLp[2], normIn, fb, damp);
-        wet += processComb(cBuf3, C3, cIdx[3], cLp[3], normIn, fb, damp);
-        wet >>= 2;  // average 4 combs
+        int32_t c0 = processComb(cBuf0, cBuf0.tap(C0), cLp[0], normIn, fb, damp);
+        int32_t c1 = processComb(cBuf1, cBuf1.tap(C1), cLp[1], normIn, fb, damp);
+        int32_t c2 = processComb(cBuf2, cBuf2.tap(C2), cLp[2], normIn, fb, damp);
+        int32_t c3 = processComb(cBuf3, Modulated ? cBuf3.tapQ8(modTapQ8(C3, lfoPhase)) : cBuf3.tap(C3),
+                                 cLp[3], normIn, fb, damp);
+        int32_t wet = (c0 + c1 + c2 + c3) >> 2;  // average 4 combs
+
+        // Right: the combs with alternating signs, through its own allpasses
+        // (the swept one half a cycle from the left's)
+        if (Stereo && right) {
+            int32_t r = (c0 - c1 + c2 - c3) >> 2;
+            r = processAllpass(aBufR0, Modulated ? aBufR0.tapQ8(modTapQ8(A0R, lfoPhase + 3 * QUADRATURE))
+                                                 : aBufR0.tap(A0R), r);
+            r = processAllpass(aBufR1, aBufR1.tap(A1R), r);
+            if (r >  2047) r =  2047;
+            if (r < -2048) r = -2048;
+            *right = (int16_t)r;
+        }
 
         // 2 allpass filters in series for diffusion
-        wet = processAllpass(aBuf0, A0, aIdx[0], wet);
-        wet = processAllpass(aBuf1, A1, aIdx[1], wet);
+        wet = processAllpass(aBuf0, Modulated ? aBuf0.tapQ8(modTapQ8(A0, lfoPhase + QUADRATURE)) : aBuf0.tap(A0), wet);
+        wet = processAllpass(aBuf1, aBuf1.tap(A1), wet);
+        if (Modulated) lfoPhase += LFO_INC;
 
         if (wet >  2047) wet =  2047;
         if (wet < -2048) wet = -2048;
         return (int16_t)wet;
     }
 
-private:
-    // Comb filter with one-pole LP damping on the feedback path.
-    // lp = (1-damp)*out + damp*lp  →  higher damp = lower cutoff = darker.
-    static int32_t processComb(int16_t* buf, int len, int& idx, int32_t& lp,
+    // Where network() takes its input and puts its output: at Rate, the
+    // block itself; at 24 kHz, two 48 kHz samples per network sample, the
+    // first low-passed into the network as in step(), and the output of each
+    // tick given out as itself and then as its average with the next
+    struct FullRateIo {
+        const int16_t* in;
+        int16_t*       out;
+        inline int32_t input(int k) const { return in[k]; }
+        inline void output(int k, int32_t wet) { out[k] = (int16_t)wet; }
+    };
+    struct HalfRateIo {
+        const int16_t* in;
+        int16_t*       out;
+        int32_t        x1, x2, yPrev, yCur;
+        inline int32_t input(int k) {
+            int32_t lpIn = (x2 + 2 * x1 + in[2 * k]) >> 2;
+            x2 = in[2 * k];
+            x1 = in[2 * k + 1];
+            return lpIn;
+        }
+        inline void output(int k, int32_t wet) {
+            yPrev = yCur;
+            yCur  = wet;
+            out[2 * k]     = (int16_t)yPrev;
+            out[2 * k + 1] = (int16_t)((yPrev + yCur) >> 1);
+        }
+    };
+
+    // tick() over n network samples from io, clipped output back to io.
+    // Swept taps are read with tapQ8At, counted back from where the line's
+    // write pointer has got to.
+    template <class Io>
+    void network(Io& io, int n, int32_t fb, int32_t damp)
+    {
+        int32_t lp0 = cLp[0], lp1 = cLp[1], lp2 = cLp[2], lp3 = cLp[3];
+        uint32_t p = lfoPhase;
+        int k = 0;
+        while (k < n) {
+            int s = n - k;
+            straight(cBuf0, C0, s);
+            straight(cBuf1, C1, s);
+            straight(cBuf2, C2, s);
+            straight(cBuf3, Modulated ? 0 : C3, s);
+            straight(aBuf0, Modulated ? 0 : A0, s);
+            straight(aBuf1, A1, s);
+
+            const uint32_t w3 = cBuf3.writePos(), wa = aBuf0.writePos();
+            int16_t* const wc0 = cBuf0.slot(cBuf0.writePos());
+            int16_t* const wc1 = cBuf1.slot(cBuf1.writePos());
+            int16_t* const wc2 = cBuf2.slot(cBuf2.writePos());
+            int16_t* const wc3 = cBuf3.slot(w3);
+            int16_t* const wa0 = aBuf0.slot(wa);
+            int16_t* const wa1 = aBuf1.slot(aBuf1.writePos());
+            const int16_t* const rc0 = cBuf0.slot(cBuf0.tapPos(C0));
+            const int16_t* const rc1 = cBuf1.slot(cBuf1.tapPos(C1));
+            const int16_t* const rc2 = cBuf2.slot(cBuf2.tapPos(C2));
+            const int16_t* const rc3 = cBuf3.slot(cBuf3.tapPos(C3));
+            const int16_t* const ra0 = aBuf0.slot(aBuf0.tapPos(A0));
+            const int16_t* const ra1 = aBuf1.slot(aBuf1.tapPos(A1));
+
+            for (int i = 0; i < s; i++) {
+                int32_t normIn = ((32768 - fb) * io.input(k + i)) >> 15;
+                int32_t o0 = rc0[i], o1 = rc1[i], o2 = rc2[i];
+                int32_t o3 = Modulated ? cBuf3.tapQ8At(w3 + i, modTapQ8(C3, p)) : rc3[i];
+                wc0[i] = combFeedback(o0, lp0, normIn, fb, damp);
+                wc1[i] = combFeedback(o1, lp1, normIn, fb, damp);
+                wc2[i] = combFeedback(o2, lp2, normIn, fb, damp);
+                wc3[i] = combFeedback(o3, lp3, normIn, fb, damp);
+                int32_t wet = (o0 + o1 + o2 + o3) >> 2;
+
+                int32_t b0 = Modulated ? aBuf0.tapQ8At(wa + i, modTapQ8(A0, p + QUADRATURE)) : ra0[i];
+                wa0[i] = allpassFeedback(b0, wet);
+                wet = b0 - wet;
+                int32_t b1 = ra1[i];
+                wa1[i] = allpassFeedback(b1, wet);
+                wet = b1 - wet;
+                if (Modulated) p += LFO_INC;
+
+                if (wet >  2047) wet =  2047;
+                if (wet < -2048) wet = -2048;
+                io.output(k + i, wet);
+            }
+            cBuf0.advance(s);
+            cBuf1.advance(s);
+            cBuf2.advance(s);
+            cBuf3.advance(s);
+            aBuf0.advance(s);
+            aBuf1.advance(s);
+            k += s;
+        }
+        cLp[0] = lp0;
+        cLp[1] = lp1;
+        cLp[2] = lp2;
+        cLp[3] = lp3;
+        lfoPhase = p;
+    }
+
+    // Shorten s so that buf's write position, and its read position len
+    // back unless len is 0, run on for s slots without wrapping
+    template <class Line>
+    static inline void straight(const Line& buf, int len, int& s)
+    {
+        if (s > Line::span(buf.writePos())) s = Line::span(buf.writePos());
+        if (len && s > Line::span(buf.tapPos(len))) s = Line::span(buf.tapPos(len));
+    }
+
+    // Q8 tap for a line of len samples swept by the LFO at phase p
+    static inline int32_t modTapQ8(int len, uint32_t p)
+    {
+        int32_t t   = (int32_t)p;
+        int32_t tri = ((t ^ (t >> 31)) >> 15) - 32768;   // triangle, -32768..32767
+        return (len << 8) + ((tri * MOD_DEPTH) >> 7);
+    }
+
+    // Comb filter with one-pole LP damping on the feedback path; out is the
+    // sample read from the line's tap.
+    static int32_t processComb(CombLine& buf, int32_t out, int32_t& lp,
                                 int32_t in, int32_t fb, int32_t damp)
     {
-        int32_t out = buf[idx];
+        buf.push(combFeedback(out, lp, in, fb, damp));
+        return out;
+    }
+
+    // What a comb writes back: lp = (1-damp)*out + damp*lp  →  higher damp =
+    // lower cutoff = darker.
+    static inline int16_t combFeedback(int32_t out, int32_t& lp, int32_t in, int32_t fb, int32_t damp)
+    {
         lp = ((32768 - damp) * out + damp * lp) >> 15;
         int32_t w = in + ((fb * lp) >> 15);
         if (w >  32767) w =  32767;
         if (w < -32768) w = -32768;
-        buf[idx] = (int16_t)w;
-        if (++idx >= len) idx = 0;
-        return out;
+        return (int16_t)w;
     }
 
-    // Schroeder allpass (gain = 0.5) for diffusion
-    static int32_t processAllpass(int16_t* buf, int len, int& idx, int32_t in)
+    // Schroeder allpass (gain = 0.5) for diffusion; b is the sample read
+    // from the line's tap
+    template <class Line>
+    static int32_t processAllpass(Line& buf, int32_t b, int32_t in)
     {
-        int32_t b   = buf[idx];
-        int32_t out = b - in;
-        int32_t w   = in + ((AP_GAIN * b) >> 15);
+        buf.push(allpassFeedback(b, in));
+        return b - in;
+    }
+
+    // What an allpass writes back
+    static inline int16_t allpassFeedback(int32_t b, int32_t in)
+    {
+        int32_t w = in + ((AP_GAIN * b) >> 15);
         if (w >  32767) w =  32767;
         if (w < -32768) w = -32768;
-        buf[idx] = (int16_t)w;
-        if (++idx >= len) idx = 0;
-        return out;
+        return (int16_t)w;
     }
 };
 
@@ -0,0 +1,86 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <stdint.h>
+#include <string.h>
+
+// Power-of-two ring buffer for delay lines.
+//
+// Indices wrap with a mask rather than a compare-and-branch, so a tap costs
+// a subtract and an AND whatever its position — the M0+ has no branch
+// prediction, and a wrap test per tap per sample adds up.  A line of L
+// samples needs 2^Log2Size > L; the slots beyond L are never read.
+//
+// Taps are counted back from the write position: tap(1) is the last sample
+// pushed, tap(d) the one pushed d samples ago.  A delay line reads its taps
+// and then pushes, so tap(L) followed by push() is an L-sample delay.
+//
+// For block processing, span() gives how many slots run on from an index
+// before the end of the array, so a loop can use plain pointers from slot()
+// up to the next wrap.
+
+template <class T, int Log2Size>
+class RingBuffer {
+public:
+    static constexpr int      SIZE = 1 << Log2Size;
+    static constexpr uint32_t MASK = SIZE - 1;
+
+    RingBuffer() : writeIdx(0) { clear(); }
+
+    void clear() {
+        memset(buf, 0, sizeof(buf));
+        writeIdx = 0;
+    }
+
+    // Store v at the write position and advance
+    inline __attribute__((always_inline)) void push(T v) {
+        buf[writeIdx] = v;
+        writeIdx = (writeIdx + 1) & MASK;
+    }
+
+    // Sample pushed d samples ago, 1 <= d <= SIZE
+    inline __attribute__((always_inline)) T tap(uint32_t d) const {
+        return buf[(writeIdx - d) & MASK];
+    }
+
+    // Linearly interpolated tap, d in Q8 samples (256 <= d <= (SIZE - 1) << 8).
+    // Blends the two samples either side of the fractional position, with the
+    // same rounding as the open-coded Q8 reads it replaces.
+    inline __attribute__((always_inline)) int32_t tapQ8(int32_t dQ8) const {
+        return tapQ8At(writeIdx, dQ8);
+    }
+
+    // As tapQ8(), counted back from index pos instead of the write position:
+    // for a loop writing through slot() that calls advance() afterwards
+    inline __attribute__((always_inline)) int32_t tapQ8At(uint32_t pos, int32_t dQ8) const {
+        uint32_t i   = (pos - ((dQ8 + 255) >> 8)) & MASK;
+        int32_t frac = (-dQ8) & 0xFF;
+        int32_t a    = buf[i];
+        return a + (((int32_t)buf[(i + 1) & MASK] - a) * frac >> 8);
+    }
+
+    // Raw slot access, index taken modulo SIZE
+    inline __attribute__((always_inline)) T&       at(uint32_t i)       { return buf[i & MASK]; }
+    inline __attribute__((always_inline)) const T& at(uint32_t i) const { return buf[i & MASK]; }
+
+    // Index of the next slot push() will write
+    inline uint32_t writePos() const { return writeIdx; }
+
+    // Advance the write position by n slots written directly through slot()
+    inline void advance(int n) { writeIdx = (writeIdx + n) & MASK; }
+
+    // Index of the slot d samples behind the write position
+    inline uint32_t tapPos(uint32_t d) const { return (writeIdx - d) & MASK; }
+
+    // Pointer to slot i, and how many slots follow it (including itself)
+    // before the array wraps
+    inline T*       slot(uint32_t i)       { return buf + (i & MASK); }
+    inline const T* slot(uint32_t i) const { return buf + (i & MASK); }
+    static inline int span(uint32_t i) { return SIZE - (int)(i & MASK); }
+
+private:
+    T        buf[SIZE];
+    uint32_t writeIdx;
+};
+
+#endif
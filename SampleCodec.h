@@ -0,0 +1,298 @@
+#ifndef SAMPLE_CODEC_H
+#define SAMPLE_CODEC_H
+
+#include <stdint.h>
+#include "MuLawCodec.h"
+
+// Sample storage codecs for 12-bit signed audio held in a byte buffer.
+//
+// A sampler picks one of these as a compile-time parameter.  Each provides:
+//
+//   TAG                   id stored alongside saved data, so a bank written
+//                         with one codec is never played back with another
+//   bytesFor(n)           bytes needed to store n samples
+//   capacity(bytes)       samples that fit in a buffer of that many bytes
+//   Encoder::write(buf, i, s)
+//                         store sample i; samples must be written in order
+//                         starting from 0 (writing i = 0 starts a new take)
+//   Reader::read(buf, i)  fetch sample i.  Any i may be read in any order,
+//                         but reading forward by small steps is what the
+//                         codecs are tuned for (one Reader per play head)
+//   Reader::needsSeek(i)  true if read(i) cannot just continue from the
+//                         Reader's current position.  A caller that knows
+//                         a better starting point (e.g. a Reader parked at
+//                         the loop start) can copy that in first.
+//
+// Reader and Encoder are small value types; copying a Reader copies its
+// position.
+
+// 8 bits per sample, µ-law.  Stateless: every sample is independent.
+struct MuLawSampleCodec {
+    static constexpr uint8_t TAG = 0;
+
+    static constexpr int bytesFor(int samples) { return samples; }
+    static constexpr int capacity(int bytes)   { return bytes; }
+
+    struct Encoder {
+        inline __attribute__((always_inline)) void write(uint8_t* buf, int idx, int16_t s) {
+            buf[idx] = MuLawCodec::encodeSample(s);
+        }
+    };
+
+    struct Reader {
+        inline __attribute__((always_inline)) int16_t read(const uint8_t* buf, int idx) {
+            return MuLawCodec::decodeSample(buf[idx]);
+        }
+        bool needsSeek(int) const { return false; }
+    };
+};
+
+// 8 bits per sample, G.711 A-law.  Like µ-law, but with a linear first
+// segment: coarser on very quiet signals, finer on loud ones.  The 12-bit
+// input is scaled ×2 into A-law's 13-bit range; tables are built at compile
+// time, as for MuLawCodec.
+struct ALawSampleCodec {
+    static constexpr uint8_t TAG = 2;
+
+    static constexpr int bytesFor(int samples) { return samples; }
+    static constexpr int capacity(int bytes)   { return bytes; }
+
+    static constexpr uint8_t encode(int16_t sample) {
+        int32_t v = (int32_t)sample * 2;            // 13-bit
+        uint8_t mask = 0xD5;
+        if (v < 0) { mask = 0x55; v = -v - 1; }
+        uint8_t seg = 0;
+        while (seg < 8 && v >= (0x20 << seg)) seg++;
+        if (seg >= 8) return (uint8_t)(0x7F ^ mask);
+        uint8_t a = (uint8_t)(seg << 4);
+        a |= (uint8_t)((seg < 2 ? (v >> 1) : (v >> seg)) & 0x0F);
+        return (uint8_t)(a ^ mask);
+    }
+
+    static constexpr int16_t decode(uint8_t a) {
+        a ^= 0x55;
+        int32_t t   = (a & 0x0F) << 4;
+        int     seg = (a & 0x70) >> 4;
+        if (seg == 0) t += 8;
+        else          t = (t + 0x108) << (seg - 1);
+        t >>= 4;                                    // 16-bit → 12-bit
+        if (t > 2047) t = 2047;
+        return (a & 0x80) ? (int16_t)t : (int16_t)-t;
+    }
+
+    struct EncodeTable {
+        uint8_t v[4096];   // index = sample + 2048
+        constexpr EncodeTable() : v() {
+            for (int i = 0; i < 4096; i++) v[i] = encode((int16_t)(i - 2048));
+        }
+    };
+    struct DecodeTable {
+        int16_t v[256];
+        constexpr DecodeTable() : v() {
+            for (int i = 0; i < 256; i++) v[i] = decode((uint8_t)i);
+        }
+    };
+    static const EncodeTable encodeTable;
+    static const DecodeTable decodeTable;
+
+    struct Encoder {
+        inline __attribute__((always_inline)) void write(uint8_t* buf, int idx, int16_t s) {
+            buf[idx] = encodeTable.v[(uint16_t)(s + 2048) & 0xFFF];
+        }
+    };
+
+    struct Reader {
+        inline __attribute__((always_inline)) int16_t read(const uint8_t* buf, int idx) {
+            return decodeTable.v[buf[idx]];
+        }
+        bool needsSeek(int) const { return false; }
+    };
+};
+
+inline constexpr ALawSampleCodec::EncodeTable ALawSampleCodec::encodeTable{};
+inline constexpr ALawSampleCodec::DecodeTable ALawSampleCodec::decodeTable{};
+
+// 12 bits per sample, uncompressed: two samples packed into three bytes,
+//   [0] a bits 0-7   [1] a bits 8-11 | b bits 0-3 << 4   [2] b bits 4-11
+struct Pcm12SampleCodec {
+    static constexpr uint8_t TAG = 3;
+
+    static constexpr int bytesFor(int samples) { return (samples * 3 + 1) / 2; }
+    static constexpr int capacity(int bytes)   { return (bytes / 3) * 2; }
+
+    struct Encoder {
+        inline __attribute__((always_inline)) void write(uint8_t* buf, int idx, int16_t s) {
+            uint8_t* p = buf + (idx >> 1) * 3;
+            uint16_t u = (uint16_t)s & 0xFFF;
+            if (idx & 1) { p[1] |= (uint8_t)(u << 4); p[2] = (uint8_t)(u >> 4); }
+            else         { p[0]  = (uint8_t)u;        p[1] = (uint8_t)(u >> 8); }
+        }
+    };
+
+    struct Reader {
+        inline __attribute__((always_inline)) int16_t read(const uint8_t* buf, int idx) {
+            const uint8_t* p = buf + (idx >> 1) * 3;
+            uint16_t u = (idx & 1) ? (uint16_t)((p[1] >> 4) | (p[2] << 4))
+                                   : (uint16_t)(p[0] | ((p[1] & 0x0F) << 8));
+            return (int16_t)((int16_t)(u << 4) >> 4);   // sign-extend 12 bits
+        }
+        bool needsSeek(int) const { return false; }
+    };
+};
+
+// 16 bits per sample, uncompressed int16 (native byte order).  Wasteful for
+// 12-bit audio, but it is the format soz has always written to flash.
+struct Pcm16SampleCodec {
+    static constexpr uint8_t TAG = 4;
+
+    static constexpr int bytesFor(int samples) { return samples * 2; }
+    static constexpr int capacity(int bytes)   { return bytes / 2; }
+
+    struct Encoder {
+        inline __attribute__((always_inline)) void write(uint8_t* buf, int idx, int16_t s) {
+            ((int16_t*)buf)[idx] = s;
+        }
+    };
+
+    struct Reader {
+        inline __attribute__((always_inline)) int16_t read(const uint8_t* buf, int idx) {
+            return ((const int16_t*)buf)[idx];
+        }
+        bool needsSeek(int) const { return false; }
+    };
+};
+
+// 4 bits per sample, IMA ADPCM.
+//
+// Samples are stored in blocks of BLOCK_SAMPLES, each headed by a 4-byte
+// checkpoint of the decoder state at the start of the block:
+//
+//   [0-1] predictor (int16, little-endian)  [2] step index  [3] reserved
+//   [4-]  BLOCK_SAMPLES / 2 bytes of codes, low nibble first
+//
+// so the buffer can be entered at any block boundary — that is what lets a
+// voice loop and seek.  The checkpoint costs 4 bytes per 128, ~3 %.
+//
+// Every byte is stored inverted, so that erased flash (0xFF) reads as
+// predictor 0, index 0 and a run of 0 codes: silence.
+//
+// The 12-bit input is run through the standard 16-bit IMA quantiser (<< 4)
+// so that the full step table is usable on quiet material.
+//
+// A Reader decodes forward from wherever it last was.  A jump backwards, or
+// forwards past a block boundary by more than it would cost to decode from
+// that block's checkpoint, restarts from the checkpoint; either way a single
+// read() decodes at most BLOCK_SAMPLES codes.
+struct AdpcmSampleCodec {
+    static constexpr uint8_t TAG = 1;
+
+    static constexpr int BLOCK_SAMPLES = 256;    // power of 2
+    static constexpr int HEADER_BYTES  = 4;
+    static constexpr int BLOCK_BYTES   = HEADER_BYTES + BLOCK_SAMPLES / 2;   // 132
+    static_assert((BLOCK_SAMPLES & (BLOCK_SAMPLES - 1)) == 0, "BLOCK_SAMPLES must be a power of 2");
+
+    static constexpr int bytesFor(int samples) {
+        int rem = samples % BLOCK_SAMPLES;
+        return (samples / BLOCK_SAMPLES) * BLOCK_BYTES + (rem ? HEADER_BYTES + (rem + 1) / 2 : 0);
+    }
+    static constexpr int capacity(int bytes) { return (bytes / BLOCK_BYTES) * BLOCK_SAMPLES; }
+
+    static constexpr int16_t STEP[89] = {
+            7,     8,     9,    10,    11,    12,    13,    14,    16,    17,
+           19,    21,    23,    25,    28,    31,    34,    37,    41,    45,
+           50,    55,    60,    66,    73,    80,    88,    97,   107,   118,
+          130,   143,   157,   173,   190,   209,   230,   253,   279,   307,
+          337,   371,   408,   449,   494,   544,   598,   658,   724,   796,
+          876,   963,  1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,
+         2272,  2499,  2749,  3024,  3327,  3660,  4026,  4428,  4871,  5358,
+         5894,  6484,  7132,  7845,  8630,  9493, 10442, 11487, 12635, 13899,
+        15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+    };
+    static constexpr int8_t INDEX_ADJ[8] = { -1, -1, -1, -1, 2, 4, 6, 8 };
+
+    // Decoder state shared by the encoder (which tracks what the decoder will
+    // see) and the reader
+    struct State {
+        int32_t pred  = 0;   // 16-bit predictor
+        int32_t index = 0;   // 0-88
+
+        // Apply one 4-bit code
+        inline __attribute__((always_inline)) void step(uint8_t code) {
+            int32_t st   = STEP[index];
+            int32_t diff = st >> 3;
+            if (code & 4) diff += st;
+            if (code & 2) diff += st >> 1;
+            if (code & 1) diff += st >> 2;
+            pred += (code & 8) ? -diff : diff;
+            if (pred >  32767) pred =  32767;
+            if (pred < -32768) pred = -32768;
+            index += INDEX_ADJ[code & 7];
+            if (index < 0)  index = 0;
+            if (index > 88) index = 88;
+        }
+    };
+
+    struct Encoder {
+        State st;
+
+        void write(uint8_t* buf, int idx, int16_t s) {
+            if (idx == 0) st = State();
+
+            int off = idx & (BLOCK_SAMPLES - 1);
+            uint8_t* blk = buf + (idx / BLOCK_SAMPLES) * BLOCK_BYTES;
+            if (off == 0) {
+                blk[0] = (uint8_t)~st.pred;
+                blk[1] = (uint8_t)~(st.pred >> 8);
+                blk[2] = (uint8_t)~st.index;
+                blk[3] = 0xFF;
+            }
+
+            // Quantise the prediction error to sign + 3 bits of step
+            int32_t diff = ((int32_t)s << 4) - st.pred;
+            uint8_t code = 0;
+            if (diff < 0) { code = 8; diff = -diff; }
+            int32_t sv = STEP[st.index];
+            if (diff >= sv) { code |= 4; diff -= sv; }
+            sv >>= 1;
+            if (diff >= sv) { code |= 2; diff -= sv; }
+            sv >>= 1;
+            if (diff >= sv) { code |= 1; }
+            st.step(code);
+
+            uint8_t* p = blk + HEADER_BYTES + (off >> 1);
+            if (off & 1) *p &= (uint8_t)~(code << 4);
+            else         *p  = (uint8_t)~code;
+        }
+    };
+
+    struct Reader {
+        State   st;
+        int     next = 0x7FFFFFFF;   // index of the next sample to decode; forces a seek first
+        int16_t last = 0;            // sample next - 1
+
+        inline __attribute__((always_inline)) bool needsSeek(int idx) const {
+            return idx < next - 1 || idx - next > (idx & (BLOCK_SAMPLES - 1));
+        }
+
+        inline __attribute__((always_inline)) int16_t read(const uint8_t* buf, int idx) {
+            if (idx == next - 1) return last;
+            if (needsSeek(idx)) {
+                const uint8_t* blk = buf + (idx / BLOCK_SAMPLES) * BLOCK_BYTES;
+                st.pred  = (int16_t)~(blk[0] | (blk[1] << 8));
+                st.index = (uint8_t)~blk[2];
+                if (st.index > 88) st.index = 88;   // corrupt header
+                next = idx & ~(BLOCK_SAMPLES - 1);
+            }
+            while (next <= idx) {
+                int off = next & (BLOCK_SAMPLES - 1);
+                uint8_t b = (uint8_t)~buf[(next / BLOCK_SAMPLES) * BLOCK_BYTES + HEADER_BYTES + (off >> 1)];
+                st.step((off & 1) ? (uint8_t)(b >> 4) : (uint8_t)(b & 0x0F));
+                next++;
+            }
+            last = (int16_t)(st.pred >> 4);
+            return last;
+        }
+    };
+};
+
+#endif
@@ -1,26 +1,36 @@
 #pragma once
 #include "ComputerCard.h"
+#include "RingBuffer.h"
+#include "hardware/sync.h"
 #include <stdint.h>
 
 // Detects pitch by measuring the period between positive-going zero crossings.
 // Averages AVG_PERIODS consecutive periods for stability.
+//
+// Each crossing is placed between the two samples either side of it by
+// linear interpolation, so periods are measured in Q8 samples rather than
+// whole ones — without that, a 2 kHz tone could only read in steps of
+// about 70 cents.
 class PitchDetector {
     static const uint16_t MIN_PERIOD  = 12;    // 4 kHz max  (48000/4000)
     static const uint16_t MAX_PERIOD  = 2400;  // 20 Hz min  (48000/20)
-    static const uint8_t  AVG_PERIODS = 8;
+    static const uint8_t  AVG_PERIODS = 8;     // power of two: the average is a shift
+    static const int16_t  HYSTERESIS  = 256;
 
     bool     above;
+    int16_t  prev;         // previous sample
     uint32_t since_last;   // samples since last positive crossing
     uint32_t timeout;      // samples since any crossing (silence detection)
+    uint16_t lastFracQ8;   // how far before its sample the last crossing was
 
-    uint32_t periods[AVG_PERIODS];
+    uint32_t periods[AVG_PERIODS];   // Q8 samples
     uint8_t  pi;           // ring-buffer write index
     uint8_t  count;        // valid periods accumulated
 
-    uint32_t result;       // averaged period (samples), 0 = unknown
+    uint32_t result;       // averaged period (Q8 samples), 0 = unknown
 
 public:
-    PitchDetector() : above(false), since_last(0), timeout(0),
+    PitchDetector() : above(false), prev(0), since_last(0), timeout(0), lastFracQ8(0),
                       pi(0), count(0), result(0) {
         for (uint8_t i = 0; i < AVG_PERIODS; i++) periods[i] = 0;
     }
@@ -29,10 +39,13 @@ public:
         since_last++;
         timeout++;
 
-        if (!above && s > 256) {
+        if (!above && s > HYSTERESIS) {
             above = true;
+            // prev <= HYSTERESIS < s: the level was crossed (s - H) / (s - prev)
+            // of a sample ago
+            uint16_t fracQ8 = divideQ8((uint32_t)(s - HYSTERESIS), (uint32_t)(s - prev));
             if (since_last >= MIN_PERIOD && since_last <= MAX_PERIOD) {
-                periods[pi] = since_last;
+                periods[pi] = (since_last << 8) + lastFracQ8 - fracQ8;
                 pi = (pi + 1) % AVG_PERIODS;
                 if (count < AVG_PERIODS) count++;
                 if (count >= AVG_PERIODS) {
@@ -48,9 +61,11 @@ public:
             }
             since_last = 0;
             timeout    = 0;
-        } else if (above && s < -256) {
+            lastFracQ8 = fracQ8;
+        } else if (above && s < -HYSTERESIS) {
             above = false;
         }
+        prev = s;
 
         // No crossing for >100 ms: declare silence
         if (timeout > 4800) {
@@ -65,48 +80,323 @@ public:
 
     // Returns averaged period in samples, or 0 if not yet determined.
     uint32_t period() const {
+        return (count >= AVG_PERIODS) ? result >> 8 : 0;
+    }
+
+    // As period(), in Q8 samples
+    uint32_t periodQ8() const {
         return (count >= AVG_PERIODS) ? result : 0;
     }
+
+private:
+    // num / den in Q8 for 0 < num <= den, by eight steps of restoring
+    // division: a fixed few dozen cycles, no divider
+    static uint16_t divideQ8(uint32_t num, uint32_t den) {
+        if (num >= den) return 256;
+        uint32_t q = 0;
+        for (int i = 0; i < 8; i++) {
+            num <<= 1;
+            q <<= 1;
+            if (num >= den) { num -= den; q |= 1; }
+        }
+        return (uint16_t)q;
+    }
 };
 
-// Convert a period (samples at 48 kHz) to deviation from the nearest C note.
+// Pitch detector after YIN (de Cheveigné & Kawahara, 2002), split across
+// the two cores.
 //
-// Returns INT16_MIN if no pitch.
-// Returns  0        if perfectly in tune with a C.
-// Returns +2047     if >= 50 cents sharp  (above C).
-// Returns -2047     if >= 50 cents flat   (below C).
-static inline int16_t periodToCloseness(uint32_t period_samples) {
-    if (period_samples == 0) return INT16_MIN;
-
-    // Frequency in mHz (avoids floats; 48 MHz fits in uint32_t)
-    uint32_t f = 48000000UL / period_samples;
-
-    // Octave-reduce into [C4, C5) = [261626, 523251) mHz
-    const uint32_t C4 = 261626;
-    const uint32_t C5 = 523251;
-    while (f < C4) f <<= 1;
-    while (f >= C5) f >>= 1;
-
-    // Cents deviation using first-order log approximation:
-    //   cents ≈ (1200/ln2) × (f−C)/C  ≈  1731 × (f−C)/C
-    // This is accurate to within ~2% for deviations up to ±100 cents.
-    //
-    // Geometric midpoint between C4 and C5 is at ~370 000 mHz (600 cents).
-    // Above that, compare to C5 to get the correct (negative) sign.
-    int32_t cents;
-    if (f >= 370000UL) {
-        cents = -(int32_t)((C5 - f) * 1731UL / C5);
-    } else {
-        cents = (int32_t)((f - C4) * 1731UL / C4);
+// addSample() runs on the audio core and only decimates: a fourth-order CIC
+// filter takes the input down to 12 kHz into a ring buffer, a few adds per
+// sample.  update() runs in the other core's main loop.  Every HOP decimated
+// samples it copies the latest window out of the ring and searches it with
+// YIN's cumulative-mean-normalised difference function: the first dip whose
+// normalised depth (interpolated between lags) falls below THRESHOLD, walked
+// down to its minimum.  The period is then refined on the dips at 2, 4, 8...
+// times it, as far as MAX_LAG: a parabola through each dip places it to a
+// fraction of a sample, and dividing by the multiple divides that error too,
+// which keeps sub-cent accuracy at the top of the range, where a period is
+// only 3-10 decimated samples long.
+//
+// The difference function compares whole stretches of waveform, so extra
+// zero crossings from strong harmonics do not pull it up an octave, and the
+// first estimate comes from one 100 ms window instead of 8 periods.
+//
+// Search cost grows with the period: WINDOW multiply-adds per lag tried,
+// from 2k at 4 kHz to 360k at 20 Hz, plus ~3 lags per doubling, and up to
+// 720k with no pitch found.  update() shares a core's main loop with USB
+// and the like, so it does a slice of the search a call and picks it up
+// again on the next: at most LAGS_PER_UPDATE lags (4800 multiply-adds,
+// ~0.3 ms on the M0+ at 125 MHz), or the copy of a new window out of the
+// ring.  A search then takes up to ~150 calls; if they come slower than a
+// HOP it simply runs less often, and it always starts on the newest
+// window.
+class YinPitchDetector {
+public:
+    static const int DECIMATE  = 4;     // analysis rate 12 kHz
+    static const int MIN_LAG   = 3;     // 4 kHz max
+    static const int MAX_LAG   = 600;   // 20 Hz min
+    static const int WINDOW    = 600;   // difference function integration window
+    static const int HOP       = 600;   // 50 ms between analyses
+    static const int THRESHOLD = 614;   // 0.15 in Q12 (YIN's absolute threshold)
+    static const int LAGS_PER_UPDATE = 8;   // difference-function lags per update() call
+
+private:
+    // One analysis reads the lags up to MAX_LAG + 1 (for the parabola)
+    static const int SPAN = WINDOW + MAX_LAG + 1;
+
+    // Below this mean (x²/4) over the window there is no signal: ~64 rms
+    static const uint32_t SILENCE = 1024;
+
+    // Audio core: CIC state (wrapping, so unsigned) and the decimated ring,
+    // 170 ms — longer than SPAN, so the audio core can keep writing while
+    // update() copies a window out
+    static const int CIC_ORDER = 4;   // gain DECIMATE⁴ = 256; -40 dB by 9 kHz
+    uint32_t integ[CIC_ORDER], comb[CIC_ORDER];
+    uint8_t  phase;
+    RingBuffer<int16_t, 11> ring;
+    volatile uint32_t written;    // decimated samples written, ever
+
+    // Analysis core
+    uint32_t analysed;            // value of written at the last analysis
+    int16_t  frame[SPAN];
+
+    // The search in progress, resumed by each update(): the stage it is at,
+    // the lag reached, d(τ-1), d(τ), d(τ+1) and Σd(1..τ) there, and while
+    // refining, the period so far (Q12 decimated samples) and the multiple
+    // of it being looked at
+    enum Stage : uint8_t { IDLE, SEARCH, DESCEND, REFINE };
+    uint8_t  stage;
+    int      tau;
+    uint32_t a, b, c;
+    uint64_t cum;
+    uint32_t p;
+    int      mult;
+
+    volatile uint32_t resultQ8;   // smoothed period, Q8 samples at 48 kHz; 0 = none
+    volatile uint16_t conf;       // 0-4095
+
+public:
+    YinPitchDetector() : phase(0), written(0), analysed(0), stage(IDLE), tau(0), a(0), b(0), c(0),
+                         cum(0), p(0), mult(0), resultQ8(0), conf(0) {
+        for (int i = 0; i < CIC_ORDER; i++) integ[i] = comb[i] = 0;
+    }
+
+    // Audio core, every sample
+    void addSample(int16_t s) {
+        uint32_t v = (uint32_t)(int32_t)s;
+        for (int i = 0; i < CIC_ORDER; i++) v = integ[i] += v;
+        if (++phase < DECIMATE) return;
+        phase = 0;
+        for (int i = 0; i < CIC_ORDER; i++) {
+            uint32_t d = v - comb[i];
+            comb[i] = v;
+            v = d;
+        }
+        uint32_t w = written;
+        ring.at(w) = (int16_t)((int32_t)v >> 8);
+        __dmb();
+        written = w + 1;
+    }
+
+    // Analysis core: start a search if HOP new samples have arrived, or
+    // carry on with the one in progress, for at most LAGS_PER_UPDATE lags.
+    // Returns true if a search finished.
+    bool update() {
+        int budget = LAGS_PER_UPDATE;
+
+        if (stage == IDLE) {
+            uint32_t w = written;
+            if (w < (uint32_t)SPAN || w - analysed < (uint32_t)HOP) return false;
+            analysed = w;
+            __dmb();
+            for (int i = 0; i < SPAN; i++) frame[i] = ring.at(w - SPAN + i);
+
+            uint32_t energy = 0;
+            for (int i = 0; i < WINDOW; i++) energy += (uint32_t)(frame[i] * frame[i]) >> 2;
+            if (energy < SILENCE * WINDOW) return finish(0);
+
+            cum   = 0;
+            a     = 0;
+            b     = diff(1);
+            tau   = 1;
+            stage = SEARCH;
+            return false;
+        }
+
+        // First lag where d'(τ) = d(τ)·τ / Σd(1..τ) is below THRESHOLD,
+        // compared cross-multiplied so there is no division per lag.  At a
+        // local minimum the depth tested is the parabola's, since a sharp
+        // dip can fall between two lags.
+        if (stage == SEARCH) {
+            for (; tau <= MAX_LAG; tau++) {
+                if (budget-- <= 0) return false;
+                cum += b;
+                c = diff(tau + 1);
+                if (tau >= MIN_LAG) {
+                    uint32_t depth = (b <= a && b < c) ? vertexDepth(a, b, c) : b;
+                    if ((uint64_t)depth * tau * 4096 < (uint64_t)THRESHOLD * cum) break;
+                }
+                a = b;
+                b = c;
+            }
+            if (tau > MAX_LAG) return finish(0);
+            stage = DESCEND;
+        }
+
+        // Down to the bottom of the dip
+        if (stage == DESCEND) {
+            while (c < b && tau < MAX_LAG) {
+                if (budget-- <= 0) return false;
+                a = b;
+                b = c;
+                cum += b;
+                tau++;
+                c = diff(tau + 1);
+            }
+            p     = ((uint32_t)tau << 12) + vertexOffsetQ12(a, b, c);
+            mult  = 2;
+            stage = REFINE;
+        }
+
+        // Period in Q12 decimated samples, then over successive doublings,
+        // up to four lags each
+        for (; (int)((p * mult) >> 12) < MAX_LAG; mult *= 2) {
+            if ((budget -= 4) < 0) return false;
+            int lag = (int)((p * mult + 2048) >> 12);
+            uint32_t dl = diff(lag - 1), d0 = diff(lag), dr = diff(lag + 1);
+            // Within a sample of the guess; step to the lower neighbour if
+            // the minimum is beyond it
+            if (dl < d0 && dl <= dr && lag - 1 > 1) { dr = d0; d0 = dl; lag--; dl = diff(lag - 1); }
+            else if (dr < d0 && lag + 1 < MAX_LAG)  { dl = d0; d0 = dr; lag++; dr = diff(lag + 1); }
+            p = (((uint32_t)lag << 12) + vertexOffsetQ12(dl, d0, dr) + mult / 2) / mult;
+        }
+        return finish((p * DECIMATE + 8) >> 4);
+    }
+
+    // True while a search is part way through, so update() has more to do
+    // whether or not new samples arrive
+    bool searching() const { return stage != IDLE; }
+
+    // Period in Q8 samples at 48 kHz, or 0 if no pitch.  Any core.
+    uint32_t periodQ8() const { return resultQ8; }
+
+    // Period in whole samples, as PitchDetector::period()
+    uint32_t period() const { return resultQ8 >> 8; }
+
+    // How periodic the last window was: 4095 × (1 - d'(τ)), 0 with no pitch
+    uint16_t confidence() const { return conf; }
+
+private:
+    // End of a search: publish the period found (Q8 samples at 48 kHz, 0 for
+    // none) and the confidence of the dip at tau
+    bool finish(uint32_t pQ8) {
+        stage = IDLE;
+        if (!pQ8) {
+            resultQ8 = 0;
+            conf     = 0;
+            return true;
+        }
+        int32_t k = 4096 - (int32_t)((uint64_t)vertexDepth(a, b, c) * tau * 4096 / cum);
+        conf = (uint16_t)(k < 0 ? 0 : k > 4095 ? 4095 : k);
+
+        // Average successive estimates of a steady pitch; jump on a new one
+        uint32_t r = resultQ8;
+        uint32_t d = pQ8 > r ? pQ8 - r : r - pQ8;
+        resultQ8 = (r && d < (r >> 6)) ? r + (uint32_t)(((int32_t)pQ8 - (int32_t)r) >> 1) : pQ8;
+        return true;
+    }
+
+    // Offset of the vertex of the parabola through d(τ-1), d(τ), d(τ+1) from
+    // τ, in Q12, within ±0.5
+    static int32_t vertexOffsetQ12(uint32_t a, uint32_t b, uint32_t c) {
+        int64_t den = (int64_t)a - 2 * (int64_t)b + c;
+        if (den <= 0) return 0;
+        int64_t f = ((int64_t)a - c) * 2048 / den;
+        return (int32_t)(f < -2048 ? -2048 : f > 2048 ? 2048 : f);
+    }
+
+    // Depth of that vertex
+    static uint32_t vertexDepth(uint32_t a, uint32_t b, uint32_t c) {
+        int64_t den = (int64_t)a - 2 * (int64_t)b + c;
+        if (den <= 0) return b;
+        int64_t e = (int64_t)a - c;
+        int64_t v = (int64_t)b - e * e / (8 * den);
+        return v < 0 ? 0 : (uint32_t)v;
     }
 
-    // Scale ±600 cents (6 semitones) to ±2047 and clamp
-    int32_t out = cents * 2047L / 600;
-    if (out >  2047) out =  2047;
+    // Squared-difference function d(τ) over the window, x²/4 so that
+    // WINDOW × 4095² / 4 fits in 32 bits
+    uint32_t diff(int tau) const {
+        uint32_t sum = 0;
+        const int16_t* x = frame;
+        const int16_t* y = frame + tau;
+        for (int i = 0; i < WINDOW; i++) {
+            int32_t e = x[i] - y[i];
+            sum += (uint32_t)(e * e) >> 2;
+        }
+        return sum;
+    }
+};
+
+// log2(x) in Q16 for x > 0: the exponent from normalising x, plus log2 of
+// the mantissa from a 64-segment table with linear interpolation (error
+// under 0.05 cents).  Five fixed normalising steps and no division, so it
+// takes the same time for any x.
+static const int32_t LOG2_MANTISSA_Q16[65] = {
+        0,  1466,  2909,  4331,  5732,  7112,  8473,  9814, 11136, 12440, 13727, 14996, 16248,
+    17484, 18704, 19909, 21098, 22272, 23433, 24579, 25711, 26830, 27936, 29029, 30109, 31178,
+    32234, 33279, 34312, 35334, 36346, 37346, 38336, 39316, 40286, 41246, 42196, 43137, 44068,
+    44990, 45904, 46809, 47705, 48593, 49472, 50344, 51207, 52063, 52911, 53751, 54584, 55410,
+    56229, 57040, 57845, 58643, 59434, 60219, 60997, 61769, 62534, 63294, 64047, 64794, 65536,
+};
+
+static inline int32_t log2Q16(uint32_t x) {
+    int32_t e = 31;
+    if (!(x & 0xFFFF0000u)) { x <<= 16; e -= 16; }
+    if (!(x & 0xFF000000u)) { x <<= 8;  e -= 8; }
+    if (!(x & 0xF0000000u)) { x <<= 4;  e -= 4; }
+    if (!(x & 0xC0000000u)) { x <<= 2;  e -= 2; }
+    if (!(x & 0x80000000u)) { x <<= 1;  e -= 1; }
+    // x is now 1.m in Q31: six bits of m pick the segment, the next 16
+    // interpolate along it
+    uint32_t i = (x >> 25) & 63;
+    int32_t  f = (int32_t)((x >> 9) & 0xFFFF);
+    int32_t  a = LOG2_MANTISSA_Q16[i];
+    return (e << 16) + a + (((LOG2_MANTISSA_Q16[i + 1] - a) * f) >> 16);
+}
+
+// Where a period (Q8 samples at 48 kHz) lies relative to the nearest C, in
+// 1/65536 octave: -32768..32767 = -600..+600 cents.
+//
+// log2 of the frequency relative to C is log2(48000 × 256 / C4) - log2(P);
+// its fractional part is the position within the octave, and the wrap to a
+// signed 16-bit value folds it onto the nearer C.  No octave loops and no
+// division.
+static inline int32_t periodQ8ToCOffset(uint32_t periodQ8) {
+    const int32_t C4_Q16 = 1017079;   // log2(48000 × 256 / 261.6256 Hz) in Q16
+    return (int16_t)(uint16_t)(C4_Q16 - log2Q16(periodQ8));
+}
+
+// Deviation of a period (Q8 samples at 48 kHz) from the nearest C note.
+//
+// Returns INT16_MIN if no pitch (period 0).
+// Returns  0        if perfectly in tune with a C.
+// Returns +2047     at 600 cents sharp (above C).
+// Returns -2047     at 600 cents flat  (below C).
+static inline int16_t periodQ8ToCloseness(uint32_t periodQ8) {
+    if (periodQ8 == 0) return INT16_MIN;
+    // ±32768 (±600 cents) → ±2047, rounded; only -32768 needs the clamp
+    int32_t out = (periodQ8ToCOffset(periodQ8) * 2047 + (1 << 14)) >> 15;
     if (out < -2047) out = -2047;
     return (int16_t)out;
 }
 
+// As periodQ8ToCloseness, from a period in whole samples
+static inline int16_t periodToCloseness(uint32_t period_samples) {
+    return periodQ8ToCloseness(period_samples << 8);
+}
+
 // Brightness values for a tuner LED triplet (flat / center / sharp).
 // Apply with: LedBrightness(ledFlat, v.flat); LedBrightness(ledCenter, v.center); etc.
 struct TunerLedValues { uint16_t flat, center, sharp; };
@@ -0,0 +1,163 @@
+#pragma once
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+#include <stdint.h>
+#include <string.h>
+
+// Closed-loop V/oct calibration of the two CV outputs.
+//
+// CVOutMIDINote is only as good as the card's DAC calibration and the 1 V/oct
+// tracking of whatever it drives.  tnr measures the real thing: with CV Out
+// → oscillator → Audio In patched, it steps the output through ANCHORS
+// voltages a nominal octave apart (-3 V .. +3 V), measures the pitch at each
+// with the tuner, and stores the pitches in a flash sector.  Any card can
+// then load() the record and play notes through cv(), which inverts the
+// measured curve piecewise-linearly so that each note lands the right number
+// of semitones from note 60 — which stays at 0 V, so the oscillator's own
+// tuning still sets the key.  Notes beyond the outer anchors extrapolate the
+// end segments.
+//
+// The correction is to the nearest CVOut step, about 3.5 cents at ±2048 =
+// ±6 V; uncalibrated outputs fall back to CVOutMIDINote.
+//
+// Cards that play notes derive from VOctCard<ComputerCard>, which loads the
+// record and gives them CVOutNote(), CVOutMIDINote through the calibration.
+//
+// The record lives in the last sector of the first 256 KB, below the sample
+// banks at the end of flash that vss uses; soz keeps the same 256 KB clear for
+// code.  Flashing a card only rewrites the sectors its image covers, so when
+// one physical card is reflashed with another program the calibration
+// survives, as long as that image ends below the record: the cards using it
+// link VOctCalibration.ld, which fails the link if they do not.  A card
+// whose image is larger, or that writes this sector, will erase it.
+//
+// The record is in the card's own flash.  A separate card holding vss, seq6
+// or umel never sees tnr's record on another card; to calibrate it, flash
+// tnr onto it, run the calibration, then flash the program back.
+
+class VOctCalibration {
+public:
+    static constexpr int      ANCHORS      = 7;
+    static constexpr int      ZERO_ANCHOR  = 3;          // the 0 V anchor, note 60
+    static constexpr int32_t  MISSING      = INT32_MIN;  // no pitch measured here
+    static constexpr uint32_t FLASH_OFFSET = 256u * 1024u - FLASH_SECTOR_SIZE;
+    static constexpr uint32_t MAGIC        = 0x564F4331u;  // 'V','O','C', version 1
+
+    // Flash record: pitch at each anchor in Q16 octaves (any common offset,
+    // higher is sharper), and a check word so a torn write reads as absent
+    struct Record {
+        uint32_t magic;
+        int32_t  pitch[2][ANCHORS];
+        uint32_t check;
+
+        uint32_t checksum() const {
+            uint32_t x = magic;
+            for (int i = 0; i < 2; i++)
+                for (int k = 0; k < ANCHORS; k++) x = (x << 1 | x >> 31) ^ (uint32_t)pitch[i][k];
+            return x;
+        }
+    };
+    static_assert(sizeof(Record) <= FLASH_PAGE_SIZE, "calibration record must fit one page");
+
+    // CVOut value of anchor k: a nominal octave (2048 / 6) apart
+    static constexpr int16_t anchorCV(int k) { return (int16_t)((k - ZERO_ANCHOR) * 2048 / 6); }
+
+    VOctCalibration() : valid(0) {}
+
+    // Read the record from flash and build the note tables.  Reads flash
+    // through XIP, so call it from a constructor or with the other core idle.
+    // Returns the mask of outputs calibrated.
+    uint8_t load() {
+        Record r;
+        memcpy(&r, (const void*)(XIP_BASE + FLASH_OFFSET), sizeof(r));
+        if (r.magic != MAGIC || r.check != r.checksum()) return valid = 0;
+        return build(r);
+    }
+
+    // Build the note tables from a record; an output is calibrated if the
+    // 0 V anchor and at least one other were measured, and pitch rises with
+    // every step at between half and twice the nominal octave.
+    // Returns the mask of outputs calibrated.
+    uint8_t build(const Record& r) {
+        valid = 0;
+        for (int i = 0; i < 2; i++)
+            if (buildOutput(i, r.pitch[i])) valid |= (uint8_t)(1 << i);
+        return valid;
+    }
+
+    // Erase the sector and program r.  Runs with interrupts off; the caller
+    // must have the other core locked out, as for any flash write.
+    static void save(Record r) {
+        static uint8_t page[FLASH_PAGE_SIZE] __attribute__((aligned(4)));
+        r.magic = MAGIC;
+        r.check = r.checksum();
+        memset(page, 0xFF, FLASH_PAGE_SIZE);
+        memcpy(page, &r, sizeof(r));
+
+        uint32_t ints = save_and_disable_interrupts();
+        flash_range_erase(FLASH_OFFSET, FLASH_SECTOR_SIZE);
+        flash_range_program(FLASH_OFFSET, page, FLASH_PAGE_SIZE);
+        restore_interrupts(ints);
+    }
+
+    bool calibrated(int i) const { return valid & (1 << i); }
+
+    // CVOut value for a MIDI note on output i; only meaningful if calibrated(i)
+    int16_t cv(int i, uint8_t note) const { return table[i][note & 0x7F]; }
+
+private:
+    uint8_t valid;
+    int16_t table[2][128];
+
+    bool buildOutput(int i, const int32_t* pitch) {
+        // The measured anchors, as octaves above the 0 V one
+        int32_t rel[ANCHORS], cvs[ANCHORS];
+        int n = 0;
+        if (pitch[ZERO_ANCHOR] == MISSING) return false;
+        for (int k = 0; k < ANCHORS; k++) {
+            if (pitch[k] == MISSING) continue;
+            rel[n] = pitch[k] - pitch[ZERO_ANCHOR];
+            cvs[n] = anchorCV(k);
+            if (n) {
+                // Per nominal octave: 1/2..2 octaves, scaled by the CV gap
+                int64_t step = (int64_t)(rel[n] - rel[n - 1]) * 341;
+                int32_t gap  = cvs[n] - cvs[n - 1];
+                if (step < (int64_t)gap * 32768 || step > (int64_t)gap * 131072) return false;
+            }
+            n++;
+        }
+        if (n < 2) return false;
+
+        for (int note = 0; note < 128; note++) {
+            int32_t target = (note - 60) * 65536 / 12;
+            int s = 0;
+            while (s < n - 2 && target > rel[s + 1]) s++;
+            int64_t num = (int64_t)(target - rel[s]) * (cvs[s + 1] - cvs[s]);
+            int32_t den = rel[s + 1] - rel[s];
+            int32_t v   = cvs[s] + (int32_t)((num + (num < 0 ? -den / 2 : den / 2)) / den);
+            if (v < -2048) v = -2048;
+            if (v >  2047) v =  2047;
+            table[i][note] = (int16_t)v;
+        }
+        return true;
+    }
+};
+
+// A card with calibrated note outputs: derive from VOctCard<ComputerCard>
+// instead of ComputerCard and play notes with CVOutNote().  The record is
+// loaded as the card is constructed.  (CVOut and CVOutMIDINote are protected
+// members of the card, so this is a base class rather than a free function.)
+template <class Card>
+class VOctCard : public Card {
+protected:
+    VOctCalibration voct;   // from tnr's calibration mode, if it has been run
+
+    VOctCard() { voct.load(); }
+
+    // CVOutMIDINote, through the calibration where there is one
+    void CVOutNote(int i, uint8_t note)
+    {
+        if (voct.calibrated(i)) this->CVOut(i, voct.cv(i, note));
+        else                    this->CVOutMIDINote(i, note);
+    }
+};
@@ -1,5 +1,6 @@
 #include <cstdint>
 #include "ComputerCard.h"
+#include "ControlRate.h"
 #include "hihat.h"
 
 //                    step: 1 2 3 4 5 6 7 8
@@ -45,6 +46,12 @@ class Dr8 : public ComputerCard
         uint32_t hihatPos = HIHAT_LEN; // start past end = silent
         uint32_t noiseSeed = 1;
 
+        // X selects bass pattern, Y selects snare pattern, read at 1 kHz
+        ControlClock<48> control;
+        ControlValue knobX, knobY;
+        int bassIdx = 0;
+        int snareIdx = 0;
+
         int16_t noise()
         {
             noiseSeed = 1664525 * noiseSeed + 1013904223;
@@ -80,9 +87,11 @@ class Dr8 : public ComputerCard
                 }
             }
 
-            // X selects bass pattern, Y selects snare pattern
-            int bassIdx = KnobVal(Knob::X) * 31 / 4095;
-            int snareIdx = KnobVal(Knob::Y) * 31 / 4095;
+            if (control.tick())
+            {
+                knobX.update(KnobVal(Knob::X), [this](int x) { bassIdx = x * 31 / 4095; });
+                knobY.update(KnobVal(Knob::Y), [this](int y) { snareIdx = y * 31 / 4095; });
+            }
 
             uint8_t bassPat = bassPatterns[bassIdx];
             uint8_t snarePat = snarePatterns[snareIdx];
@@ -1,5 +1,6 @@
 #include <cstdint>
 #include "ComputerCard.h"
+#include "ControlRate.h"
 
 constexpr int16_t BIT_12_MIN = -2048;
 constexpr int16_t BIT_12_MAX = 2047;
@@ -11,6 +12,13 @@ class NoiseTools : public ComputerCard
         uint16_t gateOut1Count = 0;
         uint32_t rnd12Seed = 1;
         int16_t sampleHoldValue = 0;
+
+        // Main knob + CV 1 (scaled by Y) set the output densities; read at
+        // 1 kHz, and the log curves only looked up when the sum moves
+        ControlClock<48> control;
+        ControlValue mainCtl;
+        uint16_t mainScaled = 0;
+        uint16_t mainScaledInv = 0;
         uint16_t Rnd12() noexcept
         {
             rnd12Seed = 1664525 * rnd12Seed + 1013904223;
@@ -93,22 +101,29 @@ class NoiseTools : public ComputerCard
                 rnd12Seed = knobXVal >> 5;
             }
 
-            uint16_t main = KnobVal(Knob::Main);
-
-            if(Connected(Input::CV1))
+            if (control.tick())
             {
-                // apply cv and cv gain
-                int32_t afterGain = main + apply_gain(CVIn1(), KnobVal(Knob::Y));
-                if(afterGain < 0)
-                    main = 0;
-                else if(afterGain > 4095)
-                    main = 4095;
-                else
-                    main = afterGain;
+                uint16_t main = KnobVal(Knob::Main);
+
+                if(Connected(Input::CV1))
+                {
+                    // apply cv and cv gain
+                    int32_t afterGain = main + apply_gain(CVIn1(), KnobVal(Knob::Y));
+                    if(afterGain < 0)
+                        main = 0;
+                    else if(afterGain > 4095)
+                        main = 4095;
+                    else
+                        main = afterGain;
+                }
+
+                mainCtl.update(main, [this](int m) {
+                    mainScaled = LogScale(m);
+                    mainScaledInv = LogScale(4095 - m);
+                    LedBrightness(0, m);
+                });
             }
 
-            const uint16_t mainScaled = LogScale(main);
-            const uint16_t mainScaledInv = LogScale(4095 - main);
             const uint16_t which = Rnd();
 
             int16_t noise = 0;
@@ -143,8 +158,6 @@ class NoiseTools : public ComputerCard
 
             CVOut2(sampleHoldValue);
 
-            LedBrightness(0, main);
-
             // regular gate thing
             if(gateOut1Count < 512)
             {
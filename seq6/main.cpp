@@ -2,8 +2,9 @@
 #include "pico/stdlib.h"
 #include "hardware/adc.h"
 #include "BucketBrigadeDelay.h"
+#include "VOctCalibration.h"
 ///
-class Seq6 : public ComputerCard
+class Seq6 : public VOctCard<ComputerCard>
 {
     static constexpr uint8_t  NUM_STAGES       = 6;
     static constexpr uint16_t DEFAULT_STEP_LEN = 48000 / 2;
@@ -13,7 +14,7 @@ class Seq6 : public ComputerCard
     static constexpr uint8_t  NOTE_RANGE       = 36;
     static constexpr uint8_t  EDIT_NOTE_OFFSET = 32;
     static constexpr uint8_t  EDIT_NOTE_RANGE  = 72;
-    static constexpr uint32_t BBD_MAX_DELAY    = 65535 * 4;
+    static constexpr uint32_t BBD_STAGES       = 65535;  // 64 KB, up to ~2.7s
     static constexpr uint16_t MIN_STEP_LEN     = 2880;   // ~60ms at 48kHz
     static constexpr uint16_t MAX_STEP_LEN     = 48000;  // 1s
 
@@ -63,7 +64,7 @@ class Seq6 : public ComputerCard
         Switch last_switch_val = Switch::Up;
         int16_t sample_and_hold = 0;
         bool reset = true;
-        static BucketBrigadeDelay bbdDelay;
+        static BucketBrigadeDelay<BBD_STAGES, uint8_t> bbdDelay;   // µ-law stages
 
         uint32_t lcg_seed = getRandomSeed();
 
@@ -195,8 +196,8 @@ class Seq6 : public ComputerCard
             }
 
             Stage stage = stages[current_stage];
-            CVOutMIDINote(0, stage.note);
-            CVOutMIDINote(1, stage.note);
+            CVOutNote(0, stage.note);
+            CVOutNote(1, stage.note);
 
             PulseOut(0, gate1.Tick());
             PulseOut(1, gate2.Tick());
@@ -283,8 +284,8 @@ class Seq6 : public ComputerCard
             current_stage = (KnobVal(Knob::Y) * NUM_STAGES) >> 12;
             LedOn(current_stage, true);
             Stage stage = stages[current_stage];
-            CVOutMIDINote(0, stage.note);
-            CVOutMIDINote(1, stage.note);
+            CVOutNote(0, stage.note);
+            CVOutNote(1, stage.note);
         }
 
         // "Catch" editing: knob must first match the current value before
@@ -328,8 +329,8 @@ class Seq6 : public ComputerCard
             if (stage.stepsEditable)
                 LedOn(stage.steps - 1);
 
-            CVOutMIDINote(0, stage.note);
-            CVOutMIDINote(1, stage.note);
+            CVOutNote(0, stage.note);
+            CVOutNote(1, stage.note);
         }
 
     public:
@@ -364,7 +365,7 @@ class Seq6 : public ComputerCard
         }
 };
 
-BucketBrigadeDelay Seq6::bbdDelay(BBD_MAX_DELAY, 200, 0, 128, 20000);
+BucketBrigadeDelay<Seq6::BBD_STAGES, uint8_t> Seq6::bbdDelay(200, 0, 128, 20000);
 
 int main()
 {
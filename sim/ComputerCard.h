@@ -0,0 +1,134 @@
+#ifndef COMPUTERCARD_H
+#define COMPUTERCARD_H
+
+// Host-side stand-in for ComputerCard.h.
+//
+// Same card-facing API as the RP2040 version (AudioIn/Out, CVIn/Out, KnobVal,
+// SwitchVal, pulse edges, Connected, LEDs), but instead of an ADC/DAC ISR the
+// inputs come from WAV files and a scripted timeline, and the outputs are
+// captured to WAV/CSV.  Run() drives ProcessSample() as fast as the host can
+// go and then exits the process — see sim.cpp.
+//
+// The include guard deliberately matches the hardware header, so that a
+// quoted #include "ComputerCard.h" from the repo root (e.g. Tuner.h) is a
+// no-op once this one has been seen.
+
+#include "pico/stdlib.h"
+#include <stdint.h>
+
+class ComputerCard
+{
+public:
+    enum Knob { Main, X, Y };
+    enum Switch { Down, Middle, Up };
+    enum Input { Audio1, Audio2, CV1, CV2, Pulse1, Pulse2 };
+    enum HardwareVersion_t { Proto1 = 0x2a, Proto2_Rev1 = 0x30, Rev1_1 = 0x0C, Unknown = 0xFF };
+    enum USBPowerState_t { DFP, UFP, Unsupported };
+
+    ComputerCard();
+    virtual ~ComputerCard() {}
+
+    // Run the simulation to the end of the configured timeline, write the
+    // outputs and exit.  Never returns, like the hardware version.
+    [[noreturn]] void Run();
+
+    void EnableNormalisationProbe() { useNormProbe = true; }
+
+    static ComputerCard* ThisPtr() { return thisptr; }
+
+    uint64_t UniqueCardID() { return 0x5eed5eed5eed5eedull; }
+
+    // Host simulation always presents as a USB device (UFP), so cards that
+    // auto-detect take their tud_* path and receive scripted MIDI.
+    USBPowerState_t USBPowerState() { return UFP; }
+
+    HardwareVersion_t HardwareVersion() { return Rev1_1; }
+
+protected:
+    virtual void ProcessSample() {}
+
+    // ---- Outputs ----
+
+    void AudioOut(int i, int16_t val)
+    {
+        if (val < -2048) val = -2048;
+        if (val >  2047) val =  2047;
+        audioOut[i] = val;
+    }
+    void AudioOut1(int16_t val) { AudioOut(0, val); }
+    void AudioOut2(int16_t val) { AudioOut(1, val); }
+
+    void CVOut(int i, int16_t val)
+    {
+        if (val < -2048) val = -2048;
+        if (val >  2047) val =  2047;
+        cvOut[i] = val;
+    }
+    void CVOut1(int16_t val) { CVOut(0, val); }
+    void CVOut2(int16_t val) { CVOut(1, val); }
+
+    // Nominal 1 V/oct: ±2048 spans ±6 V, MIDI note 60 = 0 V.
+    // The hardware version applies per-card calibration; here it is ideal.
+    void CVOutMIDINote(int i, uint8_t noteNum)
+    {
+        int32_t v = ((int32_t)noteNum - 60) * 2048 / 72;
+        if (v < -2048) v = -2048;
+        if (v >  2047) v =  2047;
+        cvOut[i] = (int16_t)v;
+    }
+    void CVOut1MIDINote(uint8_t noteNum) { CVOutMIDINote(0, noteNum); }
+    void CVOut2MIDINote(uint8_t noteNum) { CVOutMIDINote(1, noteNum); }
+
+    void PulseOut(int i, bool val) { pulseOut[i] = val; }
+    void PulseOut1(bool val) { PulseOut(0, val); }
+    void PulseOut2(bool val) { PulseOut(1, val); }
+
+    void LedOn(int i, bool value = true) { leds[i] = value ? 4095 : 0; }
+    void LedOff(int i) { leds[i] = 0; }
+    void LedBrightness(int i, uint16_t brightness) { leds[i] = brightness > 4095 ? 4095 : brightness; }
+
+    // ---- Inputs ----
+
+    int16_t AudioIn(int i) { return audioIn[i]; }
+    int16_t AudioIn1() { return audioIn[0]; }
+    int16_t AudioIn2() { return audioIn[1]; }
+
+    int16_t CVIn(int i) { return cvIn[i]; }
+    int16_t CVIn1() { return cvIn[0]; }
+    int16_t CVIn2() { return cvIn[1]; }
+
+    int16_t KnobVal(Knob ind) { return knobs[ind]; }
+
+    Switch SwitchVal() { return switchVal; }
+    bool SwitchChanged() { return switchVal != lastSwitchVal; }
+
+    bool PulseIn(int i) { return pulseIn[i]; }
+    bool PulseIn1() { return pulseIn[0]; }
+    bool PulseIn2() { return pulseIn[1]; }
+
+    bool PulseInRisingEdge(int i) { return pulseIn[i] && !lastPulseIn[i]; }
+    bool PulseIn1RisingEdge() { return PulseInRisingEdge(0); }
+    bool PulseIn2RisingEdge() { return PulseInRisingEdge(1); }
+
+    bool PulseInFallingEdge(int i) { return !pulseIn[i] && lastPulseIn[i]; }
+    bool PulseIn1FallingEdge() { return PulseInFallingEdge(0); }
+    bool PulseIn2FallingEdge() { return PulseInFallingEdge(1); }
+
+    bool Connected(Input i) { return connected[i]; }
+    bool Disconnected(Input i) { return !connected[i]; }
+
+private:
+    int16_t  audioIn[2], cvIn[2], knobs[3];
+    bool     pulseIn[2], lastPulseIn[2];
+    Switch   switchVal, lastSwitchVal;
+    bool     connected[6];
+    bool     useNormProbe;
+
+    int16_t  audioOut[2], cvOut[2];
+    bool     pulseOut[2];
+    uint16_t leds[6];
+
+    static ComputerCard* thisptr;
+};
+
+#endif
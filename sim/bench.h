@@ -0,0 +1,53 @@
+#ifndef SIM_BENCH_H
+#define SIM_BENCH_H
+
+// Shared helpers for the host micro-benchmarks (bench_*.cpp).
+//
+// Each benchmark times a kernel over many repetitions and reports ns per
+// sample.  Absolute numbers are host numbers; compare variants run in the
+// same binary against each other, not against the RP2040 budget.
+
+#include <chrono>
+#include <stdint.h>
+#include <stdio.h>
+
+// Keep the optimiser from discarding a benchmarked result
+template <typename T>
+static inline void benchKeep(const T& v) { asm volatile("" : : "g"(&v) : "memory"); }
+
+// Best-of-`runs` time for fn(), which processes `samples` samples per call.
+template <typename F>
+static double benchNsPerSample(F&& fn, uint64_t samples, int runs = 7)
+{
+    double best = 1e30;
+    for (int r = 0; r < runs; r++) {
+        auto t0 = std::chrono::steady_clock::now();
+        fn();
+        double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - t0).count();
+        if (ns < best) best = ns;
+    }
+    return best / (double)samples;
+}
+
+// Best-of-`runs` times for fa() and fb(), run alternately so that both see
+// the same machine state: for comparing two paths to each other
+template <typename A, typename B>
+static void benchNsPerSamplePair(A&& fa, B&& fb, uint64_t samples, double& nsA, double& nsB, int runs = 15)
+{
+    nsA = nsB = 1e30;
+    for (int r = 0; r < runs; r++) {
+        double a = benchNsPerSample(fa, samples, 1);
+        double b = benchNsPerSample(fb, samples, 1);
+        if (a < nsA) nsA = a;
+        if (b < nsB) nsB = b;
+    }
+}
+
+// Deterministic 12-bit test signal generator
+struct BenchRng {
+    uint32_t s = 1;
+    int16_t next12() { s = 1664525u * s + 1013904223u; return (int16_t)((int32_t)(s >> 20) - 2048); }
+};
+
+#endif
@@ -0,0 +1,351 @@
+// Host benchmark: BandpassFilter's default (Q2.30, int64) and Fast (32-bit,
+// deltas about z = 1) kernels on the table-driven coefficients, and the calculateCoefficients()
+// and kernel they replace, all measured against an ideal double-precision
+// RBJ bandpass.
+//
+// Each filter hears sines at the centre and an octave either side, for notes
+// from 24 to 120 and a few resonance steps, and its gain is compared with the
+// ideal filter's at the same frequency:
+//
+//   centre   worst gain error at the centre, dB
+//   skirt    worst gain error an octave either side, dB
+//   half     as centre, on notes half a semitone up (interpolated)
+//
+// The old code is measured at the same centre frequency (rounded to Hz) and
+// at resonances giving the nearest Q its linear mapping reaches.  Its
+// reciprocal approximations leave resonance with no effect and the centre
+// 30 dB or more down, and some settings silent, which reads as the 120 dB
+// measurement floor.
+//
+// Stability: the 32-bit kernel, and the same kernel truncating without error
+// feedback, hear a second of noise and then ten of silence at low and high
+// notes and resonances.  SNR is against a double-precision biquad with the
+// same quantised coefficients, so it counts only the arithmetic; the residue is
+// the largest output in the last second of silence (a limit cycle if not 0).
+//
+// Then process() ns/sample with the centre still, and retuned every sample
+// with setNoteQ8(), for both kernels and the old one (retuned with
+// setFrequency()).  The host has a 64-bit multiplier, so the int64 kernels
+// cost far less here than on the M0+.
+//
+// Exits 1 if the default kernel is out by more than 0.5 dB at a centre,
+// whole or half note, or 1 dB on a skirt; if the 32-bit kernel is out by
+// more than 1 dB anywhere over notes 24-120; or if it idles more than 8 LSBs
+// from zero.
+
+#include "BandPass.h"
+#include "bench.h"
+#include <math.h>
+
+static constexpr int SR = 48000;
+
+typedef BandpassFilter<SR>       Bandpass;        // Q2.30, int64
+typedef BandpassFilter<SR, true> FastBandpass;    // deltas in Qk, 32-bit
+
+// The coefficient calculation and kernel from before the table, unchanged
+// but for its sine and reciprocal tables being filled in at run time
+class LegacyBandpass {
+    int32_t x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+    int32_t a0 = 0, a1 = 0, a2 = 0, b1 = 0, b2 = 0;
+    uint32_t sampleRate = SR, frequency = 1000;
+    uint16_t resonance = 2048;
+    static int32_t SIN_TABLE[256];
+    static int32_t RECIPROCAL_TABLE[256];
+
+    static int32_t fixedMul(int32_t a, int32_t b) { return (int32_t)(((int64_t)a * b) >> 16); }
+    static int32_t fastDiv(int32_t numerator, int32_t denominator) {
+        if (denominator > 0 && denominator < 256) return fixedMul(numerator, RECIPROCAL_TABLE[denominator]);
+        int32_t shift = 0, temp = denominator;
+        while (temp > 1) { temp >>= 1; shift++; }
+        return numerator >> shift;
+    }
+    static int32_t fixedSin(int32_t angle) {
+        while (angle >= 411775) angle -= 411775;
+        while (angle < 0) angle += 411775;
+        uint32_t index = ((uint32_t)angle * 1024) >> 16;
+        if (index >= 1024) index = 1023;
+        if (index < 256) return SIN_TABLE[index];
+        if (index < 512) return SIN_TABLE[511 - index];
+        if (index < 768) return -SIN_TABLE[index - 512];
+        return -SIN_TABLE[1023 - index];
+    }
+    static int32_t fixedCos(int32_t angle) { return fixedSin(angle + 102944); }
+    void calculateCoefficients() {
+        int32_t fs_reciprocal = fastDiv(65536, (int32_t)sampleRate);
+        int32_t omega = fixedMul((int32_t)frequency << 16, fixedMul(411775, fs_reciprocal));
+        int32_t cosw = fixedCos(omega), sinw = fixedSin(omega);
+        int32_t Q_scaled = 6554 + fixedMul((int32_t)resonance << 4, 478);
+        int32_t two_Q_reciprocal = fastDiv(65536, Q_scaled >> 15);
+        int32_t alpha = fixedMul(sinw, two_Q_reciprocal);
+        int32_t norm_reciprocal = fastDiv(65536, (65536 + alpha) >> 16);
+        a0 = fixedMul(alpha, norm_reciprocal);
+        a1 = 0;
+        a2 = -fixedMul(alpha, norm_reciprocal);
+        b1 = fixedMul(fixedMul(-2 * cosw, 65536), norm_reciprocal);
+        b2 = fixedMul(65536 - alpha, norm_reciprocal);
+    }
+
+public:
+    static void initTables() {
+        for (int i = 0; i < 256; i++) {
+            SIN_TABLE[i] = (int32_t)lround(65536.0 * sin(2.0 * M_PI * i / 256.0));
+            RECIPROCAL_TABLE[i] = i ? 65536 / i : 0;
+        }
+    }
+    LegacyBandpass() { calculateCoefficients(); }
+    void setFrequency(uint32_t freq) {
+        if (freq > 10 && freq < sampleRate / 2) { frequency = freq; calculateCoefficients(); }
+    }
+    void setResonance(uint16_t res) {
+        if (res <= 4095) { resonance = res; calculateCoefficients(); }
+    }
+    int16_t process(int16_t input) {
+        int32_t x0 = (int32_t)input << 16;
+        int32_t output = fixedMul(a0, x0) + fixedMul(a1, x1) + fixedMul(a2, x2) - fixedMul(b1, y1) - fixedMul(b2, y2);
+        x2 = x1; x1 = x0; y2 = y1; y1 = output;
+        int32_t result = output >> 16;
+        if (result < -2048) result = -2048;
+        if (result > 2047) result = 2047;
+        return (int16_t)result;
+    }
+};
+int32_t LegacyBandpass::SIN_TABLE[256];
+int32_t LegacyBandpass::RECIPROCAL_TABLE[256];
+
+static double noteHz(double note) { return 440.0 * pow(2.0, (note - 69.0) / 12.0); }
+static double stepQ(int step)     { return 0.1 * pow(300.0, step / 31.0); }
+
+// Gain of the ideal RBJ bandpass (0 dB peak) at hz, in dB
+static double idealDb(double centre, double q, double hz)
+{
+    double w0 = 2.0 * M_PI * centre / SR, alpha = sin(w0) / (2.0 * q), w = 2.0 * M_PI * hz / SR;
+    double b0 = alpha, a1 = -2.0 * cos(w0), a2 = 1.0 - alpha;
+    // |b0 (1 - z^-2)| / |(1 + alpha) + a1 z^-1 + a2 z^-2|
+    double nr = b0 * (1.0 - cos(2.0 * w)), ni = b0 * sin(2.0 * w);
+    double dr = 1.0 + alpha + a1 * cos(w) + a2 * cos(2.0 * w), di = -a1 * sin(w) - a2 * sin(2.0 * w);
+    return 10.0 * log10((nr * nr + ni * ni) / (dr * dr + di * di));
+}
+
+// Measured gain of f at hz, in dB: a sine, one second to settle, then a
+// second measured
+template <class F>
+static double measuredDb(F& f, double hz)
+{
+    const double amp = 1000.0;
+    double re = 0.0, im = 0.0;
+    for (int i = 0; i < 2 * SR; i++) {
+        double ph = 2.0 * M_PI * hz * i / SR;
+        int16_t y = f.process((int16_t)lround(amp * sin(ph)));
+        if (i < SR) continue;
+        re += y * cos(ph);
+        im += y * sin(ph);
+    }
+    double a = 2.0 * sqrt(re * re + im * im) / SR;
+    return 20.0 * log10((a > 1e-3 ? a : 1e-3) / amp);
+}
+
+static const int STEPS[] = { 0, 10, 20, 31 };
+
+// Worst gain errors of one kernel at one resonance step
+struct Errors {
+    double all[3] = {};      // centre, skirt, half
+};
+
+template <class F>
+static void measure(F& f, double centre, double q, double hz, int k, Errors& e)
+{
+    double err = fabs(measuredDb(f, hz) - idealDb(centre, q, hz));
+    if (err > e.all[k]) e.all[k] = err;
+}
+
+static void print(const char* name, double q, const Errors& e)
+{
+    printf("Q %5.2f  %-7s centre %6.2f dB  skirt %6.2f dB  half %6.2f dB\n", q, name, e.all[0], e.all[1], e.all[2]);
+}
+
+static bool response()
+{
+    bool ok = true;
+    for (int step : STEPS) {
+        double q = stepQ(step);
+        // The old mapping was linear, Q = 0.1 + res * 29.9 / 4095
+        long legacyRes = lround((q - 0.1) * 4095.0 / 29.9);
+        Errors fast, precise, legacy;
+        for (int note = 24; note <= 120; note += 6) {
+            for (int half = 0; half < 2; half++) {
+                double centre = noteHz(note + 0.5 * half);
+                for (int oct = -1; oct <= 1; oct++) {
+                    if (half && oct) continue;
+                    double hz = centre * pow(2.0, oct);
+                    if (hz >= SR / 2) continue;
+                    int k = half ? 2 : (oct ? 1 : 0);
+
+                    FastBandpass f;
+                    f.setResonance((uint16_t)(step << 7));
+                    f.setNoteQ8((uint16_t)(note * 256 + half * 128));
+                    measure(f, centre, q, hz, k, fast);
+
+                    Bandpass p;
+                    p.setResonance((uint16_t)(step << 7));
+                    p.setNoteQ8((uint16_t)(note * 256 + half * 128));
+                    measure(p, centre, q, hz, k, precise);
+
+                    LegacyBandpass l;
+                    l.setResonance((uint16_t)legacyRes);
+                    l.setFrequency((uint32_t)lround(centre));
+                    measure(l, round(centre), q, hz, k, legacy);
+                }
+            }
+        }
+        print("32-bit", q, fast);
+        print("precise", q, precise);
+        print("legacy", q, legacy);
+        if (precise.all[0] > 0.5 || precise.all[1] > 1.0 || precise.all[2] > 0.5) ok = false;
+        if (fast.all[0] > 1.0 || fast.all[1] > 1.0 || fast.all[2] > 1.0) ok = false;
+    }
+    return ok;
+}
+
+// The 32-bit kernel's a0, c1 = 2 + b1 and c2 = 1 - b2 in Qk, worked out
+// from a table entry as toDeltas() does
+struct Deltas {
+    int32_t a0, c1, c2, k;
+    explicit Deltas(const Bandpass::Coeffs& c) {
+        uint32_t u1 = 0x80000000u + (uint32_t)c.b1, u2 = (uint32_t)((1 << 30) - c.b2);
+        uint32_t sum = (u1 >> 2) + (u2 >> 2) + ((uint32_t)c.a0 >> 1);
+        for (k = 26; k > 14 && sum > (1u << (47 - k)); k--) {}
+        int down = 30 - k;
+        a0 = (int32_t)(((uint32_t)c.a0 + (1u << (down - 1))) >> down);
+        c1 = (int32_t)((u1 + (1u << (down - 1))) >> down);
+        c2 = (int32_t)((u2 + (1u << (down - 1))) >> down);
+    }
+};
+
+// The 32-bit kernel without error feedback: plain truncation
+struct TruncatingBiquad {
+    Deltas d;
+    int32_t x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+    explicit TruncatingBiquad(const Deltas& deltas) : d(deltas) {}
+    int16_t process(int16_t x0) {
+        int32_t y = 2 * y1 - y2 - ((d.c1 * y1 - d.c2 * y2 - d.a0 * (x0 - x2)) >> d.k);
+        y = y < -2048 ? -2048 : y > 2047 ? 2047 : y;
+        x2 = x1; x1 = x0; y2 = y1; y1 = y;
+        return (int16_t)y;
+    }
+};
+
+// The same coefficients in double precision
+struct DoubleBiquad {
+    double a0, b1, b2, x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+    double process(double x0) {
+        double y = a0 * (x0 - x2) - b1 * y1 - b2 * y2;
+        x2 = x1; x1 = x0; y2 = y1; y1 = y;
+        return y;
+    }
+};
+
+// SNR against ref over a second of noise, and the largest output in the
+// last second of ten of silence after it
+template <class F>
+static void stability(F& f, DoubleBiquad ref, double& snrDb, int& residue)
+{
+    BenchRng rng;
+    double sig = 0.0, err = 0.0;
+    for (int i = 0; i < SR; i++) {
+        int16_t x = rng.next12() >> 1;
+        double r = ref.process(x), y = f.process(x);
+        sig += r * r;
+        err += (y - r) * (y - r);
+    }
+    residue = 0;
+    for (int i = 0; i < 10 * SR; i++) {
+        int y = f.process(0);
+        if (i >= 9 * SR && abs(y) > residue) residue = abs(y);
+    }
+    snrDb = err > 0.0 ? 10.0 * log10(sig / err) : 99.0;
+}
+
+static bool stable()
+{
+    bool ok = true;
+    static const int NOTES[] = { 24, 36, 48, 60, 84, 108 };
+    static const int STEPS_STABLE[] = { 0, 31 };
+    for (int note : NOTES) {
+        for (int step : STEPS_STABLE) {
+            Deltas d(Bandpass::coefficients(note, step));
+            double one = ldexp(1.0, d.k);
+            DoubleBiquad ref;
+            ref.a0 = d.a0 / one;
+            ref.b1 = d.c1 / one - 2.0;
+            ref.b2 = 1.0 - d.c2 / one;
+
+            FastBandpass f;
+            f.setResonance((uint16_t)(step << 7));
+            f.setFrequencyFromMidi((uint8_t)note);
+            TruncatingBiquad t(d);
+            double snrF, snrT;
+            int resF, resT;
+            stability(f, ref, snrF, resF);
+            stability(t, ref, snrT, resT);
+            printf("stable   note %3d  Q %5.2f  k %2d  32-bit SNR %5.1f dB residue %4d  truncating SNR %5.1f dB residue %4d\n",
+                   note, stepQ(step), (int)d.k, snrF, resF, snrT, resT);
+            if (resF > 8) ok = false;
+        }
+    }
+    return ok;
+}
+
+template <class F>
+static void cpuRow(const char* name, F& f, const int16_t* in, int16_t* out, const uint16_t* notes)
+{
+    f.setFrequency(1000);
+    double still = benchNsPerSample([&] {
+        for (int i = 0; i < SR; i++) out[i] = f.process(in[i]);
+        benchKeep(out);
+    }, SR);
+    double retuned = benchNsPerSample([&] {
+        for (int i = 0; i < SR; i++) { f.setNoteQ8(notes[i]); out[i] = f.process(in[i]); }
+        benchKeep(out);
+    }, SR);
+    printf("cpu      %-7s process() %6.3f ns/sample  retuned every sample %6.3f ns/sample\n", name, still, retuned);
+}
+
+static void cpu()
+{
+    static int16_t in[SR], out[SR];
+    static uint16_t notes[SR];
+    static uint32_t hz[SR];
+    BenchRng rng;
+    for (int i = 0; i < SR; i++) {
+        in[i] = rng.next12() >> 1;
+        notes[i] = (uint16_t)(48 * 256 + (i * 37) % (48 * 256));   // a sweep over four octaves
+        hz[i]    = (uint32_t)noteHz(notes[i] / 256.0);
+    }
+    static FastBandpass f;
+    static Bandpass p;
+    static LegacyBandpass l;
+    cpuRow("32-bit", f, in, out, notes);
+    cpuRow("precise", p, in, out, notes);
+    l.setFrequency(1000);
+    double still = benchNsPerSample([&] {
+        for (int i = 0; i < SR; i++) out[i] = l.process(in[i]);
+        benchKeep(out);
+    }, SR);
+    double retuned = benchNsPerSample([&] {
+        for (int i = 0; i < SR; i++) { l.setFrequency(hz[i]); out[i] = l.process(in[i]); }
+        benchKeep(out);
+    }, SR);
+    printf("cpu      %-7s process() %6.3f ns/sample  retuned every sample %6.3f ns/sample\n", "legacy", still, retuned);
+}
+
+int main()
+{
+    LegacyBandpass::initTables();
+    printf("table    %u bytes\n", (unsigned)(sizeof(Bandpass::Coeffs) * Bandpass::NOTES * Bandpass::RES_STEPS));
+    bool ok = response();
+    if (!ok) printf("FAIL: filter response out of tolerance\n");
+    bool steady = stable();
+    if (!steady) printf("FAIL: 32-bit kernel limit cycle over 8 LSBs\n");
+    cpu();
+    return ok && steady ? 0 : 1;
+}
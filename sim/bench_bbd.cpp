@@ -0,0 +1,304 @@
+// Host benchmark: BucketBrigadeDelay, fixed-clock (interpolated read) against
+// Clocked mode (fixed stage count, variable clock).
+//
+// Both use int8_t stages, with the tone filter open and no feedback, so
+// what is measured is the line itself — the fixed-clock one with seq6's
+// 65535 stages, the clocked one with 4096 (an MN3005-sized line):
+//
+//   delay    where an impulse comes out, against the delay asked for
+//   response gain and spurious output (everything that is not the input
+//            tone: images, aliases, quantisation noise), both in dB relative
+//            to the input, for sine tones at a short, a medium and a long
+//            delay
+//   cpu      process() ns/sample at a fixed delay, and with the delay
+//            changing every 1000 samples
+//
+// Stage formats: a 250 Hz sine at levels from 0 to -48 dBFS through
+// int8_t, µ-law (uint8_t) and int16_t stages, SNR of each against the int16_t
+// line's output (so only what the stage format loses is counted), and
+// process() ns/sample for each.
+//
+// Then the chorus: processChorus() with 1-3 taps on one 1024-stage line
+// against three separate lines, for RAM and ns/sample, and what each tap
+// count does to a 1 kHz tone: how widely its spectrum spreads, which the
+// sweep sets whatever the taps, and how much its level beats (rms envelope
+// deviation, % of the mean), which is what more taps add: one tap only
+// bends the pitch, several are at different pitches at once.
+//
+// Exits 1 if either mode puts the impulse more than 1% from the delay set,
+// if µ-law stages are noisier than int8_t ones at any level, or if three
+// chorus taps do not beat more than ten times as much as one.
+
+#include "BucketBrigadeDelay.h"
+#include "bench.h"
+#include <math.h>
+
+static constexpr int SR = 48000;
+
+typedef BucketBrigadeDelay<65535>              FixedBbd;
+typedef BucketBrigadeDelay<4096, int8_t, true> ClockedBbd;
+
+static constexpr uint32_t DELAYS[] = { 4800, 24000, 96000 };    // 100 ms, 0.5 s, 2 s
+static constexpr int      TONES[]  = { 250, 1000, 2000, 4000, 8000 };
+static constexpr int      WINDOW   = SR / 5;                    // whole cycles of every tone
+
+// Run until the delay has reached its target (the fixed-clock mode slews to
+// it, the clocked mode glides its clock)
+template <class B>
+static void settle(B& bbd)
+{
+    while (bbd.getCurrentDelaySamples() != bbd.getTargetDelaySamples()) bbd.process(0);
+}
+
+// Sample at which the impulse response peaks
+template <class B>
+static uint32_t impulsePeak(B& bbd, uint32_t delay)
+{
+    bbd = B(0, 0, 0, 65535);
+    bbd.setDelaySamples(delay);
+    settle(bbd);
+    bbd.clear();
+    uint32_t peakAt = 0;
+    int peak = 0;
+    for (uint32_t i = 0; i < delay * 2; i++) {
+        int y = bbd.process(i < 8 ? 2047 : 0);          // short pulse: 8-bit stages and
+        if (y > peak) { peak = y; peakAt = i; }         // 24 kHz reach need more than one
+    }
+    return peakAt;
+}
+
+// Gain of a sine at hz, and the spurious output, in dB relative to the input
+template <class B>
+static void response(B& bbd, uint32_t delay, int hz, double& gainDb, double& spurDb)
+{
+    const double amp = 1000.0;
+    bbd = B(0, 0, 0, 65535);
+    bbd.setDelaySamples(delay);
+    settle(bbd);
+    const uint32_t start = delay + SR / 10;
+    double re = 0.0, im = 0.0, total = 0.0;
+    for (uint32_t i = 0; i < start + WINDOW; i++) {
+        double ph = 2.0 * M_PI * hz * (double)i / SR;
+        int16_t y = bbd.process((int16_t)lround(amp * sin(ph)));
+        if (i < start) continue;
+        re += y * cos(ph);
+        im += y * sin(ph);
+        total += (double)y * y;
+    }
+    double tone = 2.0 * (re * re + im * im) / WINDOW;   // energy in the tone
+    const double input = amp * amp * WINDOW / 2.0;
+    gainDb = 10.0 * log10(tone / input);
+    spurDb = 10.0 * log10((total - tone) / input);
+}
+
+template <class B>
+static bool run(const char* name, B& bbd)
+{
+    bool ok = true;
+    printf("%s  (%u stages, %u bytes)\n", name, B::STAGES, (unsigned)sizeof(B));
+    for (uint32_t d : DELAYS) {
+        uint32_t at = impulsePeak(bbd, d);
+        double err = 100.0 * ((double)at - d) / d;
+        printf("  delay %6u  impulse at %6u (%+5.2f %%)\n", d, at, err);
+        if (fabs(err) > 1.0) ok = false;
+    }
+    for (uint32_t d : DELAYS) {
+        printf("  delay %4u ms  gain/spurious dB:", d * 1000 / SR);
+        for (int hz : TONES) {
+            double g, s;
+            response(bbd, d, hz, g, s);
+            printf("  %4d Hz %6.1f/%6.1f", hz, g, s);
+        }
+        printf("\n");
+    }
+
+    static int16_t in[SR];
+    static int16_t out[SR];
+    BenchRng rng;
+    for (int i = 0; i < SR; i++) in[i] = rng.next12() >> 1;
+    double fixedNs = benchNsPerSample([&] {
+        bbd.setDelaySamples(24000);
+        for (int i = 0; i < SR; i++) out[i] = bbd.process(in[i]);
+        benchKeep(out);
+    }, SR);
+    double movingNs = benchNsPerSample([&] {
+        for (int i = 0; i < SR; i++) {
+            if (i % 1000 == 0) bbd.setDelaySamples(12000 + (uint32_t)(i % 7) * 6000);
+            out[i] = bbd.process(in[i]);
+        }
+        benchKeep(out);
+    }, SR);
+    printf("  cpu  %6.3f ns/sample fixed delay, %6.3f ns/sample delay moving\n", fixedNs, movingNs);
+    return ok;
+}
+
+typedef BucketBrigadeDelay<24000>          Int8Bbd;
+typedef BucketBrigadeDelay<24000, uint8_t> MuLawBbd;
+typedef BucketBrigadeDelay<24000, int16_t> Int16Bbd;
+
+template <class B>
+static void runFormat(B& bbd, const int16_t* in, int16_t* out, int n)
+{
+    bbd = B(0, 0, 0, 65535);
+    bbd.setDelaySamples(4800);
+    for (int i = 0; i < n; i++) out[i] = bbd.process(in[i]);
+}
+
+static double snrDb(const int16_t* ref, const int16_t* y, int from, int n)
+{
+    double sig = 0.0, err = 0.0;
+    for (int i = from; i < n; i++) {
+        sig += (double)ref[i] * ref[i];
+        err += (double)(y[i] - ref[i]) * (y[i] - ref[i]);
+    }
+    return err > 0.0 ? 10.0 * log10(sig / err) : 99.0;
+}
+
+// Returns false if µ-law is noisier than int8_t at any level
+static bool formats()
+{
+    const int n = SR / 2 + 4800;
+    static int16_t in[n], ref[n], y8[n], yMu[n];
+    static Int8Bbd  b8;
+    static MuLawBbd bMu;
+    static Int16Bbd b16;
+    bool ok = true;
+    printf("stages   %u each: int8_t %u bytes, µ-law %u bytes, int16_t %u bytes\n", Int8Bbd::STAGES,
+           (unsigned)sizeof(Int8Bbd), (unsigned)sizeof(MuLawBbd), (unsigned)sizeof(Int16Bbd));
+    for (int db = 0; db >= -48; db -= 12) {
+        double amp = 2047.0 * pow(10.0, db / 20.0);
+        for (int i = 0; i < n; i++) in[i] = (int16_t)lround(amp * sin(2.0 * M_PI * 250.0 * i / SR));
+        runFormat(b16, in, ref, n);
+        runFormat(b8,  in, y8,  n);
+        runFormat(bMu, in, yMu, n);
+        double s8 = snrDb(ref, y8, 4800 + SR / 10, n), sMu = snrDb(ref, yMu, 4800 + SR / 10, n);
+        printf("stages   %+3d dBFS  SNR int8_t %5.1f dB  µ-law %5.1f dB  (%+5.1f dB)\n", db, s8, sMu, sMu - s8);
+        if (sMu < s8) ok = false;
+    }
+
+    static int16_t noise[SR];
+    static int16_t out[SR];
+    BenchRng rng;
+    for (int i = 0; i < SR; i++) noise[i] = rng.next12() >> 1;
+    auto timed = [&](auto& bbd) {
+        return benchNsPerSample([&] {
+            for (int i = 0; i < SR; i++) {
+                if (i % 1000 == 0) bbd.setDelaySamples(12000 + (uint32_t)(i % 7) * 4000);
+                out[i] = bbd.process(noise[i]);
+            }
+            benchKeep(out);
+        }, SR);
+    };
+    double ns8 = timed(b8), nsMu = timed(bMu), ns16 = timed(b16);
+    printf("stages   process() int8_t %6.3f  µ-law %6.3f  int16_t %6.3f ns/sample\n", ns8, nsMu, ns16);
+    return ok;
+}
+
+typedef BucketBrigadeDelay<1024> ChorusBbd;
+
+// A 1 kHz tone through the chorus for two LFO cycles: how far either side
+// of 1 kHz (Hz) holds 90% of the output energy, in 0.5 Hz bins
+static double spreadHz(ChorusBbd& c)
+{
+    const int len = SR * 10 / 3;
+    const int BINS = 80;
+    static double y[SR * 10 / 3];
+    for (int i = 0; i < SR + len; i++) {
+        int16_t v = c.processChorus((int16_t)lround(1500.0 * sin(2.0 * M_PI * 1000.0 * i / SR)));
+        if (i >= SR) y[i - SR] = v;
+    }
+    double e[2 * BINS + 1], total = 0.0;
+    for (int b = -BINS; b <= BINS; b++) {
+        double w = 2.0 * M_PI * (1000.0 + 0.5 * b) / SR, re = 0.0, im = 0.0;
+        for (int i = 0; i < len; i++) { re += y[i] * cos(w * i); im += y[i] * sin(w * i); }
+        e[b + BINS] = re * re + im * im;
+        total += e[b + BINS];
+    }
+    double inside = e[BINS];
+    int k = 0;
+    while (inside < 0.9 * total && k < BINS) {
+        k++;
+        inside += e[BINS - k] + e[BINS + k];
+    }
+    return 0.5 * k;
+}
+
+// The same tone's envelope, demodulated at 1 kHz and averaged over a cycle:
+// its rms deviation from the mean, in % of the mean.  One tap only bends
+// the pitch, so the level stays put; taps at different points of the sweep
+// are at different pitches at once and beat against each other.
+static double beatPercent(ChorusBbd& c)
+{
+    const int len = SR * 10 / 3, AVG = SR / 1000;
+    static double re[SR * 10 / 3], im[SR * 10 / 3];
+    for (int i = 0; i < SR + len; i++) {
+        double ph = 2.0 * M_PI * 1000.0 * i / SR;
+        int16_t v = c.processChorus((int16_t)lround(1500.0 * sin(ph)));
+        if (i >= SR) { re[i - SR] = v * cos(ph); im[i - SR] = v * sin(ph); }
+    }
+    double sum = 0.0, sq = 0.0, sr = 0.0, si = 0.0;
+    int n = 0;
+    for (int i = 0; i < len; i++) {
+        sr += re[i];
+        si += im[i];
+        if (i >= AVG) { sr -= re[i - AVG]; si -= im[i - AVG]; }
+        if (i < AVG) continue;
+        double a = sqrt(sr * sr + si * si);
+        sum += a;
+        sq  += a * a;
+        n++;
+    }
+    double mean = sum / n;
+    return 100.0 * sqrt(sq / n - mean * mean) / mean;
+}
+
+// Returns false if three taps do not beat more than ten times as much as one
+static bool chorus()
+{
+    static ChorusBbd c;
+    static ChorusBbd three[3];
+    static int16_t in[SR];
+    static int16_t out[SR];
+    BenchRng rng;
+    for (int i = 0; i < SR; i++) in[i] = rng.next12() >> 1;
+
+    printf("chorus   one line %u bytes, three lines %u bytes\n",
+           (unsigned)sizeof(ChorusBbd), (unsigned)(3 * sizeof(ChorusBbd)));
+    double beats[4] = {};
+    for (int taps = 1; taps <= 3; taps++) {
+        c = ChorusBbd(0, 0, 0);
+        c.setChorus(taps, 480, 240, 600);     // 10 ms ± 5 ms at 0.6 Hz
+        double spread = spreadHz(c);
+        c = ChorusBbd(0, 0, 0);
+        c.setChorus(taps, 480, 240, 600);
+        beats[taps] = beatPercent(c);
+        double ns = benchNsPerSample([&] {
+            for (int i = 0; i < SR; i++) out[i] = c.processChorus(in[i]);
+            benchKeep(out);
+        }, SR);
+        printf("chorus   %d tap%s  %6.3f ns/sample  90%% of a 1 kHz tone within ±%4.1f Hz  beating %5.1f %%\n",
+               taps, taps > 1 ? "s" : " ", ns, spread, beats[taps]);
+    }
+    for (auto& t : three) t.setDelaySamples(480);
+    double ns = benchNsPerSample([&] {
+        for (int i = 0; i < SR; i++)
+            out[i] = (int16_t)((three[0].process(in[i]) + three[1].process(in[i]) + three[2].process(in[i])) / 3);
+        benchKeep(out);
+    }, SR);
+    printf("chorus   three lines, process() each  %6.3f ns/sample (unmodulated)\n", ns);
+    return beats[3] > 10.0 * beats[1];
+}
+
+int main()
+{
+    static FixedBbd   fixed;
+    static ClockedBbd clocked;
+    bool ok = run("fixed clock", fixed);
+    ok = run("clocked    ", clocked) && ok;
+    if (!ok) printf("FAIL: impulse more than 1%% from the delay set\n");
+    bool companded = formats();
+    if (!companded) printf("FAIL: µ-law stages noisier than int8_t\n");
+    bool ensemble = chorus();
+    if (!ensemble) printf("FAIL: three chorus taps beat no more than one\n");
+    return ok && companded && ensemble ? 0 : 1;
+}
@@ -0,0 +1,239 @@
+// Host benchmark: sample storage codecs, quality vs cost.
+//
+// Runs a fixed corpus through every SampleCodec (raw 12-bit, µ-law, A-law,
+// IMA ADPCM) and prints, per codec and signal, SNR and maximum error of the
+// decoded signal; THD on a coherent 1 kHz sine; and encode/decode ns/sample
+// over the whole corpus, read back sequentially as a voice would.
+//
+// The corpus is generated here, so results are repeatable:
+//   sweep     log sine sweep 20 Hz - 12 kHz, near full scale
+//   quiet     the same sweep at -36 dB, where companding earns its keep
+//   hihat     dr8's hihatSample
+//   speech    a synthetic voice: pitched pulse train through three formant
+//             resonators, syllable envelope, fricative bursts
+//   noise     full-scale white noise
+//
+// Quality is deterministic, so it is checked against the floors in LIMITS
+// below and the program exits non-zero if any codec falls short — run it
+// after touching SampleCodec.h or MuLawCodec.h.  Timing depends on the
+// host and is reported only.
+
+#include "SampleCodec.h"
+#include "dr8/hihat.h"
+#include "bench.h"
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+static constexpr int FS = 48000;
+
+struct Signal {
+    const char*          name;
+    std::vector<int16_t> x;
+};
+
+static int16_t clip12(double v)
+{
+    long r = lround(v);
+    if (r >  2047) r =  2047;
+    if (r < -2048) r = -2048;
+    return (int16_t)r;
+}
+
+static Signal sweep(const char* name, double amp)
+{
+    Signal s{ name, {} };
+    const int    n  = FS * 2;
+    const double f0 = 20.0, f1 = 12000.0, k = log(f1 / f0), T = (double)n / FS;
+    for (int i = 0; i < n; i++) {
+        double t = (double)i / FS;
+        double phase = 2.0 * M_PI * f0 * T / k * (exp(t / T * k) - 1.0);
+        s.x.push_back(clip12(amp * sin(phase)));
+    }
+    return s;
+}
+
+static Signal hihat()
+{
+    Signal s{ "hihat", {} };
+    s.x.assign(hihatSample, hihatSample + sizeof(hihatSample) / sizeof(hihatSample[0]));
+    return s;
+}
+
+static Signal speech()
+{
+    Signal s{ "speech", {} };
+    const double formants[3] = { 700.0, 1220.0, 2600.0 };
+    const double bw[3]       = { 110.0, 120.0, 160.0 };
+    double a1[3], a2[3], y1[3] = {}, y2[3] = {};
+    for (int f = 0; f < 3; f++) {
+        double r = exp(-M_PI * bw[f] / FS);
+        a1[f] = 2.0 * r * cos(2.0 * M_PI * formants[f] / FS);
+        a2[f] = -r * r;
+    }
+    BenchRng rng;
+    double glottal = 0.0;
+    for (int i = 0; i < FS * 2; i++) {
+        double t    = (double)i / FS;
+        double f0   = 120.0 + 30.0 * sin(2.0 * M_PI * 0.7 * t);
+        double env  = 0.5 - 0.5 * cos(2.0 * M_PI * 4.0 * t);       // syllables
+        bool   fric = fmod(t, 0.75) > 0.62;                         // "s" bursts
+        glottal += f0 / FS;
+        double exc = 0.0;
+        if (glottal >= 1.0) { glottal -= 1.0; exc = 1.0; }
+        double in = fric ? rng.next12() / 2048.0 * 0.15 : exc * env;
+        double out = 0.0;
+        for (int f = 0; f < 3; f++) {
+            double y = in + a1[f] * y1[f] + a2[f] * y2[f];
+            y2[f] = y1[f]; y1[f] = y;
+            out += y / (f + 1);
+        }
+        s.x.push_back(clip12(out * 90.0));
+    }
+    return s;
+}
+
+static Signal noise()
+{
+    Signal s{ "noise", {} };
+    BenchRng rng;
+    for (int i = 0; i < FS; i++) s.x.push_back(rng.next12());
+    return s;
+}
+
+// 1 kHz sine, exactly 48 samples per cycle, for THD
+static Signal tone()
+{
+    Signal s{ "1k", {} };
+    for (int i = 0; i < FS; i++) s.x.push_back(clip12(1800.0 * sin(2.0 * M_PI * i / 48.0)));
+    return s;
+}
+
+template <class C>
+static void roundTrip(const std::vector<int16_t>& in, std::vector<int16_t>& out)
+{
+    std::vector<uint8_t> buf(C::bytesFor((int)in.size()) + 4);
+    typename C::Encoder enc;
+    for (int i = 0; i < (int)in.size(); i++) enc.write(buf.data(), i, in[i]);
+    typename C::Reader rd;
+    out.resize(in.size());
+    for (int i = 0; i < (int)in.size(); i++) out[i] = rd.read(buf.data(), i);
+}
+
+struct Quality { double snr; int maxErr; };
+
+static Quality measure(const std::vector<int16_t>& a, const std::vector<int16_t>& b)
+{
+    double sig = 0.0, err = 0.0;
+    int maxErr = 0;
+    for (size_t i = 0; i < a.size(); i++) {
+        int e = b[i] - a[i];
+        sig += (double)a[i] * a[i];
+        err += (double)e * e;
+        if (abs(e) > maxErr) maxErr = abs(e);
+    }
+    return { err > 0.0 ? 10.0 * log10(sig / err) : 99.0, maxErr };
+}
+
+// THD in %, harmonics 2-10 of a 48-sample-period tone, by DFT at each bin
+static double thd(const std::vector<int16_t>& y)
+{
+    double p[11] = {};
+    for (int h = 1; h <= 10; h++) {
+        double re = 0.0, im = 0.0;
+        for (size_t i = 0; i < y.size(); i++) {
+            double w = 2.0 * M_PI * h * (double)(i % 48) / 48.0;
+            re += y[i] * cos(w);
+            im += y[i] * sin(w);
+        }
+        p[h] = re * re + im * im;
+    }
+    double harm = 0.0;
+    for (int h = 2; h <= 10; h++) harm += p[h];
+    return 100.0 * sqrt(harm / p[1]);
+}
+
+// Quality floors: minimum SNR (dB) and largest allowed error (12-bit LSBs),
+// per codec, in corpus order.  Set from the current codecs, a little below
+// what they achieve; tighten them when a codec gets better.
+static constexpr int NUM_SIGNALS = 5;
+struct Limits { const char* codec; double minSnr[NUM_SIGNALS]; int maxErr[NUM_SIGNALS]; double maxThd; };
+static const Limits LIMITS[] = {
+//                   sweep  quiet  hihat  speech noise     sweep quiet hihat speech noise   THD %
+    { "pcm12",    {  98.0,  98.0,  98.0,  98.0,  98.0 }, {    0,    0,    0,    0,    0 }, 0.01 },
+    { "mulaw",    {  38.9,  26.5,  36.2,  36.4,  37.2 }, {   32,    2,   32,   32,   65 }, 0.55 },
+    { "alaw",     {  38.4,  29.4,  36.9,  37.0,  38.0 }, {   32,    1,   32,   32,   32 }, 0.42 },
+    { "adpcm",    {  28.5,  26.1,  19.0,  19.6,  15.8 }, {  256,    7,  921,  606, 2077 }, 0.40 },
+};
+
+struct Corpus {
+    std::vector<Signal>  signals;
+    Signal               sine;
+    std::vector<int16_t> all;    // everything, back to back, for timing
+};
+
+template <class C>
+static bool run(const char* name, const Corpus& corpus)
+{
+    const Limits* lim = nullptr;
+    for (const Limits& l : LIMITS) if (!strcmp(l.codec, name)) lim = &l;
+
+    bool ok = true;
+    std::vector<int16_t> out;
+    printf("%-6s %5.2f bits/sample\n", name, 8.0 * C::bytesFor(1 << 16) / (1 << 16));
+    for (int s = 0; s < NUM_SIGNALS; s++) {
+        const Signal& sig = corpus.signals[s];
+        roundTrip<C>(sig.x, out);
+        Quality q = measure(sig.x, out);
+        bool pass = q.snr >= lim->minSnr[s] && q.maxErr <= lim->maxErr[s];
+        ok &= pass;
+        printf("  %-7s SNR %6.2f dB  max err %5d%s\n", sig.name, q.snr, q.maxErr,
+               pass ? "" : "   << below limit");
+    }
+    roundTrip<C>(corpus.sine.x, out);
+    double t = thd(out);
+    bool pass = t <= lim->maxThd;
+    ok &= pass;
+    printf("  %-7s THD %7.3f %%%s\n", corpus.sine.name, t, pass ? "" : "   << above limit");
+
+    // Timing over the whole corpus
+    const int n = (int)corpus.all.size();
+    std::vector<uint8_t> buf(C::bytesFor(n) + 4);
+    std::vector<int16_t> back(n);
+    double enc = benchNsPerSample([&] {
+        typename C::Encoder e;
+        for (int i = 0; i < n; i++) e.write(buf.data(), i, corpus.all[i]);
+        benchKeep(buf[0]);
+    }, (uint64_t)n);
+    double dec = benchNsPerSample([&] {
+        typename C::Reader r;
+        for (int i = 0; i < n; i++) back[i] = r.read(buf.data(), i);
+        benchKeep(back[0]);
+    }, (uint64_t)n);
+    printf("  encode %6.3f ns/sample  decode %6.3f ns/sample\n", enc, dec);
+    return ok;
+}
+
+int main()
+{
+    Corpus c;
+    c.signals.push_back(sweep("sweep", 2000.0));
+    c.signals.push_back(sweep("quiet", 2000.0 / 64.0));
+    c.signals.push_back(hihat());
+    c.signals.push_back(speech());
+    c.signals.push_back(noise());
+    c.sine = tone();
+    for (const Signal& s : c.signals) c.all.insert(c.all.end(), s.x.begin(), s.x.end());
+
+    bool ok = true;
+    ok &= run<Pcm12SampleCodec>("pcm12", c);
+    ok &= run<MuLawSampleCodec>("mulaw", c);
+    ok &= run<ALawSampleCodec>("alaw", c);
+    ok &= run<AdpcmSampleCodec>("adpcm", c);
+
+    if (!ok) {
+        printf("FAIL: codec quality below limits\n");
+        return 1;
+    }
+    return 0;
+}
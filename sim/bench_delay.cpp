@@ -0,0 +1,295 @@
+// Host benchmark: Delay::process per sample vs Delay::processBlock, and the
+// delay line storage formats.
+//
+// For each storage format, feeds two identical delays the same noise, one a
+// sample at a time and one in blocks, first with the knob still and then
+// with it stepping every few blocks so that the slew path is exercised.
+// Checks the outputs match sample for sample, then reports ns/sample for
+// each path at a few block sizes.
+//
+// Each format is also compared against the exact int16 line on a decaying
+// tone burst, so the SNR figure covers the repeats as well as the first echo.
+//
+// Then Crossfade mode against slewing, for jumps in delay time both ways:
+//
+//   echo     how long after it was sent an impulse comes back, if it was
+//            sent two thirds of the new delay before the jump, against the
+//            new delay
+//   spurious energy in the output that is not the input's 1 kHz tone, over
+//            the 200 ms after the jump, in dB relative to the tone
+//   cpu      process() ns/sample with the delay still, slewing, and
+//            crossfading most of the time, and crossfading against still
+//            next to what one more buffer read and multiply costs a copy
+//            of the still-knob process()
+//
+// Exits 1 if process and processBlock disagree, if Crossfade mode's echo is
+// not at the new delay, if Crossfade mode with the knob still is more than
+// 5% slower than the default mode, or if crossfading adds more than one more
+// read and multiply would, with 5% to spare.
+
+#include "Delay.h"
+#include "bench.h"
+#include <math.h>
+#include <string.h>
+
+static constexpr int N    = 48000;   // 1 s
+static constexpr int REPS = 8;
+static constexpr int LEN  = 36000;   // 750 ms, as vss
+
+static int16_t in[N], outRef[N], outBlk[N], burst[N], exact[N];
+
+// Knob value for sample i: still, or a new position every 4800 samples
+static int knobAt(int i, bool moving) { return moving ? ((i / 4800) * 1499) & 4095 : 2048; }
+
+template <class D>
+static bool check(D& ref, D& blk, int block, bool moving)
+{
+    ref = D();
+    blk = D();
+    for (int pass = 0; pass < 3; pass++) {   // several passes to wrap the buffer
+        for (int i = 0; i < N; i++) outRef[i] = ref.process(in[i], knobAt(i, moving));
+        for (int i = 0; i < N; i += block) {
+            int n = (N - i < block) ? N - i : block;
+            blk.processBlock(in + i, outBlk + i, n, knobAt(i, moving));
+        }
+        if (memcmp(outRef, outBlk, sizeof(outRef))) return false;
+    }
+    return true;
+}
+
+// Output of d for the burst at the shortest delay, long enough for the
+// repeats to die away
+template <class D>
+static void echoes(D& d, int16_t* out)
+{
+    d = D();
+    for (int i = 0; i < N; i += 16) d.processBlock(burst + i, out + i, 16, 0);
+}
+
+template <class S>
+static bool run(const char* name)
+{
+    typedef Delay<LEN, S> D;
+    static D ref, blk;
+
+    // Blocks never straddle a knob change, so per-sample and per-block knob
+    // reads agree and the outputs can be compared exactly
+    static const int BLOCKS[] = { 1, 15, 16, 32, 48, 96 };
+    for (int b : BLOCKS) {
+        for (int moving = 0; moving < 2; moving++) {
+            if (!check(ref, blk, b, moving)) {
+                printf("%s mismatch: block %d, knob %s\n", name, b, moving ? "moving" : "still");
+                return false;
+            }
+        }
+    }
+
+    echoes(ref, outRef);
+    double sig = 0.0, err = 0.0;
+    for (int i = 0; i < N; i++) {
+        double e = outRef[i] - exact[i];
+        sig += (double)exact[i] * exact[i];
+        err += e * e;
+    }
+    printf("%-8s %6d bytes  echo SNR %6.2f dB\n", name, (int)(S::CELLS(LEN) * sizeof(typename S::cell_t)),
+           err > 0.0 ? 10.0 * log10(sig / err) : 99.0);
+
+    static const int TIMED_BLOCKS[] = { 16, 32, 48 };
+    for (int moving = 0; moving < 2; moving++) {
+        double perSample = benchNsPerSample([&] {
+            for (int r = 0; r < REPS; r++) {
+                for (int i = 0; i < N; i++) outRef[i] = ref.process(in[i], knobAt(i, moving));
+                benchKeep(outRef);
+            }
+        }, (uint64_t)N * REPS);
+        printf("  knob %-6s  process      %6.3f ns/sample\n", moving ? "moving" : "still", perSample);
+        for (int b : TIMED_BLOCKS) {
+            double block = benchNsPerSample([&] {
+                for (int r = 0; r < REPS; r++) {
+                    for (int i = 0; i < N; i += b) {
+                        int n = (N - i < b) ? N - i : b;
+                        blk.processBlock(in + i, outBlk + i, n, knobAt(i, moving));
+                    }
+                    benchKeep(outBlk);
+                }
+            }, (uint64_t)N * REPS);
+            printf("  knob %-6s  processBlock %6.3f ns/sample  (n=%d, %.2fx)\n",
+                   moving ? "moving" : "still", block, b, perSample / block);
+        }
+    }
+    return true;
+}
+
+typedef Delay<LEN, Int16DelayStorage>       SlewDelay;
+typedef Delay<LEN, Int16DelayStorage, true> FadeDelay;
+
+// Delay's process() reading straight at the knob's delay, without slewing,
+// and with Extra, one more buffer read and one more multiply by a crossfade
+// gain: what a crossfade may add to the interpolated read
+template <bool Extra>
+struct BoundDelay {
+    int16_t buf[LEN];
+    int     writeIdx = 0;
+    int32_t lpState = 0;
+
+    int16_t __attribute__((section(".time_critical.DelayProcess"))) process(int16_t input, int knobY)
+    {
+        int32_t delayQ8 = SlewDelay::samplesForKnob(knobY) << 8;
+        int32_t readPosQ8 = (writeIdx << 8) - delayQ8;
+        if (readPosQ8 < 0) readPosQ8 += (LEN << 8);
+        int r0   = readPosQ8 >> 8;
+        int r1   = (r0 + 1 < LEN) ? r0 + 1 : 0;
+        int frac = readPosQ8 & 0xFF;
+        int r2   = r0 - LEN / 3;
+        if (r2 < 0) r2 += LEN;
+        int32_t a = buf[r0];
+        int32_t delayed = a + (((buf[r1] - a) * frac) >> 8);
+        if (Extra) delayed += (buf[r2] * delayCrossfadeTable.v[writeIdx & 255][1]) >> 15;
+
+        lpState += (13107 * (delayed - lpState)) >> 15;
+        int32_t w = (((int32_t)input * 16384) >> 15) + ((21299 * lpState) >> 15);
+        if (w >  2047) w =  2047;
+        if (w < -2048) w = -2048;
+        buf[writeIdx] = (int16_t)w;
+        if (++writeIdx >= LEN) writeIdx = 0;
+        if (delayed >  2047) delayed =  2047;
+        if (delayed < -2048) delayed = -2048;
+        return (int16_t)delayed;
+    }
+};
+static constexpr int JUMP_AT = N;       // well after the line has filled
+
+// Delay of the first echo after the jump from knob a to b of an impulse sent
+// two thirds of the new delay before it: still in the line at the jump
+template <class D>
+static int echoAt(D& d, int a, int b)
+{
+    const int sent = JUMP_AT - D::samplesForKnob(b) * 2 / 3;
+    d = D();
+    for (int i = 0; i < 2 * N; i++) {
+        int16_t y = d.process(i == sent ? 2047 : 0, i < JUMP_AT ? a : b);
+        if (i >= JUMP_AT && y > 200) return i - sent;
+    }
+    return -1;
+}
+
+// Spurious output over the 200 ms after the jump from knob a to b, with a
+// 1 kHz tone in, in dB relative to the tone
+template <class D>
+static double spuriousDb(D& d, int a, int b)
+{
+    const int len = 48000 / 5;
+    d = D();
+    double re = 0.0, im = 0.0, total = 0.0;
+    for (int i = 0; i < JUMP_AT + len; i++) {
+        double ph = 2.0 * M_PI * 1000.0 * i / 48000.0;
+        int16_t y = d.process((int16_t)lround(1000.0 * sin(ph)), i < JUMP_AT ? a : b);
+        if (i < JUMP_AT) continue;
+        re += y * cos(ph);
+        im += y * sin(ph);
+        total += (double)y * y;
+    }
+    double tone = 2.0 * (re * re + im * im) / len;
+    return 10.0 * log10((total - tone) / tone);
+}
+
+static bool jumps()
+{
+    static SlewDelay slew;
+    static FadeDelay fade, fadeBlk;
+    bool ok = true;
+
+    static const int BLOCKS[] = { 1, 16, 48 };
+    for (int b : BLOCKS) {
+        for (int moving = 0; moving < 2; moving++) {
+            if (!check(fade, fadeBlk, b, moving)) {
+                printf("crossfade mismatch: block %d, knob %s\n", b, moving ? "moving" : "still");
+                ok = false;
+            }
+        }
+    }
+
+    static const int JUMPS[][2] = { { 3000, 1500 }, { 1500, 3000 }, { 2048, 0 } };
+    for (auto& j : JUMPS) {
+        int want = SlewDelay::samplesForKnob(j[1]);
+        int atSlew = echoAt(slew, j[0], j[1]), atFade = echoAt(fade, j[0], j[1]);
+        printf("jump     %5d -> %5d samples  echo at: slew %5d  crossfade %5d  "
+               "spurious dB: slew %6.1f  crossfade %6.1f\n",
+               SlewDelay::samplesForKnob(j[0]), want, atSlew, atFade,
+               spuriousDb(slew, j[0], j[1]), spuriousDb(fade, j[0], j[1]));
+        if (atFade != want) ok = false;
+    }
+
+    // Knob still; stepping every 4800 samples, so slewing most of the time;
+    // stepping every 600 (crossfade mode), so fading 512 samples in 600
+    static int still[N], every4800[N], every600[N];
+    for (int i = 0; i < N; i++) {
+        still[i]     = 2048;
+        every4800[i] = ((i / 4800) * 1499) & 4095;
+        every600[i]  = ((i / 600) * 1499) & 4095;
+    }
+    auto run = [&](auto& d, const int* knob) {
+        return [&d, knob] {
+            for (int r = 0; r < REPS; r++) {
+                for (int i = 0; i < N; i++) outRef[i] = d.process(in[i], knob[i]);
+                benchKeep(outRef);
+            }
+        };
+    };
+    static BoundDelay<false> plain;
+    static BoundDelay<true>  extra;
+    const uint64_t samples = (uint64_t)N * REPS;
+    const double slewing = benchNsPerSample(run(slew, every4800), samples);
+
+    // A fade may add one read and one multiply to the interpolated read, so
+    // crossfading against Delay still may cost at most what the extra read
+    // and multiply cost BoundDelay.  All five are timed in turn, as the host
+    // now and then runs everything slower for a while, and a check that
+    // fails is timed again, up to three times.
+    double stillNs, fadeStill, fading, plainNs, extraNs;
+    bool stillOk = false, fadeOk = false;
+    for (int attempt = 0; attempt < 3 && !(stillOk && fadeOk); attempt++) {
+        stillNs = fadeStill = fading = plainNs = extraNs = 1e30;
+        auto best = [&](double& ns, auto fn) {
+            double t = benchNsPerSample(fn, samples, 1);
+            if (t < ns) ns = t;
+        };
+        for (int r = 0; r < 41; r++) {
+            best(stillNs,   run(slew, still));
+            best(fadeStill, run(fade, still));
+            best(fading,    run(fade, every600));
+            best(plainNs,   run(plain, every600));
+            best(extraNs,   run(extra, every600));
+        }
+        stillOk = fadeStill <= stillNs * 1.05;
+        fadeOk  = fading / stillNs <= extraNs / plainNs * 1.05;
+    }
+    printf("jump     process() knob still %6.3f ns/sample (crossfade mode %6.3f, %.2fx)  slewing %6.3f\n",
+           stillNs, fadeStill, fadeStill / stillNs, slewing);
+    printf("jump     crossfading %6.3f ns/sample, %.2fx still; one more read and multiply %.2fx\n",
+           fading, fading / stillNs, extraNs / plainNs);
+    if (!ok) printf("FAIL: crossfade mode mismatch or echo not at the new delay\n");
+    if (!stillOk) printf("FAIL: crossfade mode with the knob still is slower than the default mode\n");
+    if (!fadeOk)  printf("FAIL: crossfading costs more than one more read and multiply\n");
+    return ok && stillOk && fadeOk;
+}
+
+int main()
+{
+    BenchRng rng;
+    for (int i = 0; i < N; i++) in[i] = rng.next12();
+
+    // 440 Hz burst, 100 ms, fading in and out, then silence
+    for (int i = 0; i < 4800; i++)
+        burst[i] = (int16_t)lround(2000.0 * sin(M_PI * i / 4800.0) * sin(2.0 * M_PI * 440.0 * i / 48000.0));
+    static Delay<LEN, Int16DelayStorage> exactDelay;
+    echoes(exactDelay, exact);
+
+    bool ok = true;
+    ok &= run<Int16DelayStorage>("int16");
+    ok &= run<Packed12DelayStorage>("packed12");
+    ok &= run<Int8DelayStorage>("int8");
+    ok &= run<MuLawDelayStorage>("mulaw");
+    ok &= jumps();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,395 @@
+// Host benchmark: RingBuffer, and the Reverb and BucketBrigadeDelay rebuilt on
+// it, against what they replaced.
+//
+//   ring     RingBuffer against a plain array with a compare-and-wrap index:
+//            tap() and tapPos() at every distance, tapQ8() at every Q8
+//            distance against Delay's open-coded read, span()/slot() at every
+//            index, and a line written through slot()/advance() against one
+//            written with push()
+//   reverb   Reverb<> against the Reverb it replaced (plain arrays, wrap by
+//            compare), copied below: 20 s of noise bursts with the knob
+//            sweeping, through process() and processBlock()
+//   bbd      BucketBrigadeDelay<N, int8_t> against the heap-allocated one it
+//            replaced, copied below, at a long line, one whose length is not
+//            a power of two and the minimum: noise with the delay, feedback
+//            and slew changing.  The old one kept positions in 16.16
+//            samples, which overflow past 65535 samples; the current one
+//            keeps them in stages and does not, so lines are compared up to
+//            32767 stages, the longest the old one handled.
+//
+// Each is checked sample for sample, and the old and new process() timed.
+// Exits 1 on any mismatch.
+
+#include "RingBuffer.h"
+#include "Reverb.h"
+#include "BucketBrigadeDelay.h"
+#include "bench.h"
+#include <memory>
+#include <string.h>
+
+static constexpr int SR = 48000;
+
+// ---------------------------------------------------------------------------
+// Reverb before RingBuffer, as it was
+
+class LegacyReverb {
+    static constexpr int C0 = 1214, C1 = 1389, C2 = 1547, C3 = 1693;
+    static constexpr int A0 =  605, A1 =  371;
+
+    int16_t cBuf0[C0], cBuf1[C1], cBuf2[C2], cBuf3[C3];
+    int16_t aBuf0[A0], aBuf1[A1];
+    int32_t cLp[4];
+    int     cIdx[4];
+    int     aIdx[2];
+
+    static constexpr int32_t AP_GAIN = 16384;
+
+public:
+    LegacyReverb() {
+        memset(cBuf0, 0, sizeof(cBuf0)); memset(cBuf1, 0, sizeof(cBuf1));
+        memset(cBuf2, 0, sizeof(cBuf2)); memset(cBuf3, 0, sizeof(cBuf3));
+        memset(aBuf0, 0, sizeof(aBuf0)); memset(aBuf1, 0, sizeof(aBuf1));
+        memset(cLp,   0, sizeof(cLp));
+        memset(cIdx,  0, sizeof(cIdx));
+        memset(aIdx,  0, sizeof(aIdx));
+    }
+
+    int16_t process(int16_t input, int knobY)
+    {
+        int32_t fb   = 16384 + ((int32_t)knobY * 14746) / 4096;
+        int32_t damp = 3277  + ((int32_t)knobY * 18022) / 4096;
+        int32_t normIn = ((32768 - fb) * (int32_t)input) >> 15;
+
+        int32_t wet = 0;
+        wet += processComb(cBuf0, C0, cIdx[0], cLp[0], normIn, fb, damp);
+        wet += processComb(cBuf1, C1, cIdx[1], cLp[1], normIn, fb, damp);
+        wet += processComb(cBuf2, C2, cIdx[2], cLp[2], normIn, fb, damp);
+        wet += processComb(cBuf3, C3, cIdx[3], cLp[3], normIn, fb, damp);
+        wet >>= 2;
+
+        wet = processAllpass(aBuf0, A0, aIdx[0], wet);
+        wet = processAllpass(aBuf1, A1, aIdx[1], wet);
+
+        if (wet >  2047) wet =  2047;
+        if (wet < -2048) wet = -2048;
+        return (int16_t)wet;
+    }
+
+private:
+    static int32_t processComb(int16_t* buf, int len, int& idx, int32_t& lp,
+                                int32_t in, int32_t fb, int32_t damp)
+    {
+        int32_t out = buf[idx];
+        lp = ((32768 - damp) * out + damp * lp) >> 15;
+        int32_t w = in + ((fb * lp) >> 15);
+        if (w >  32767) w =  32767;
+        if (w < -32768) w = -32768;
+        buf[idx] = (int16_t)w;
+        if (++idx >= len) idx = 0;
+        return out;
+    }
+
+    static int32_t processAllpass(int16_t* buf, int len, int& idx, int32_t in)
+    {
+        int32_t b   = buf[idx];
+        int32_t out = b - in;
+        int32_t w   = in + ((AP_GAIN * b) >> 15);
+        if (w >  32767) w =  32767;
+        if (w < -32768) w = -32768;
+        buf[idx] = (int16_t)w;
+        if (++idx >= len) idx = 0;
+        return out;
+    }
+};
+
+// ---------------------------------------------------------------------------
+// BucketBrigadeDelay before RingBuffer, as it was, less the setters and
+// getters not used here (softClip was already out of the signal path)
+
+class LegacyBbd {
+    int8_t* buffer;
+    uint16_t writePos;
+    uint16_t bufferSize;
+
+    uint8_t clockCounter;
+    const uint8_t clockDivider = 2;
+
+    int8_t filterState;
+    uint8_t filterCoeff;
+    int8_t clipThreshold;
+
+    uint8_t feedbackAmount;
+
+    uint32_t targetDelaySamples;
+    uint32_t currentDelaySamples;
+    int32_t delaySlewRate;
+
+    inline int8_t pack12to8(int16_t sample12) {
+        return static_cast<int8_t>((sample12 >> 4) & 0xFF);
+    }
+
+    inline int16_t unpack8to12(int8_t sample8) {
+        return static_cast<int16_t>(sample8) << 4;
+    }
+
+    inline int8_t lowpass8(int8_t input) {
+        int16_t diff = input - filterState;
+        int16_t delta = (diff * filterCoeff) >> 8;
+        filterState += delta;
+        return filterState;
+    }
+
+    inline int8_t interpolateRead(uint32_t delaySamplesFP) {
+        uint32_t delayStagesFP = delaySamplesFP >> 1;
+        uint32_t delayStages = delayStagesFP >> 16;
+        uint16_t frac = delayStagesFP & 0xFFFF;
+
+        if (delayStages >= (uint32_t)(bufferSize - 1)) {
+            delayStages = bufferSize - 2;
+            frac = 0;
+        }
+
+        int32_t readPos1 = (int32_t)writePos - (int32_t)delayStages;
+        if (readPos1 < 0) readPos1 += bufferSize;
+        int32_t readPos2 = readPos1 - 1;
+        if (readPos2 < 0) readPos2 += bufferSize;
+
+        int8_t sample1 = buffer[readPos1];
+        int8_t sample2 = buffer[readPos2];
+
+        int32_t interpolated = ((int32_t)sample1 * (65536 - frac) +
+                                (int32_t)sample2 * frac) >> 16;
+        return (int8_t)interpolated;
+    }
+
+public:
+    LegacyBbd(uint32_t maxDelaySamples, uint8_t filterAmount = 200, uint8_t clipAmount = 64,
+              uint8_t feedback = 128, uint16_t slewRate = 100)
+        : writePos(0), clockCounter(0), filterState(0), feedbackAmount(feedback) {
+        bufferSize = maxDelaySamples / clockDivider;
+        buffer = new int8_t[bufferSize];
+        memset(buffer, 0, bufferSize);
+        filterCoeff = 255 - filterAmount;
+        if (filterCoeff < 10) filterCoeff = 10;
+        clipThreshold = 100 - (clipAmount >> 2);
+        if (clipThreshold < 20) clipThreshold = 20;
+        targetDelaySamples = maxDelaySamples << 16;
+        currentDelaySamples = maxDelaySamples << 16;
+        delaySlewRate = slewRate;
+    }
+
+    ~LegacyBbd() { delete[] buffer; }
+
+    int16_t process(int16_t input12) {
+        bool clockTick = false;
+        clockCounter++;
+        if (clockCounter >= clockDivider) {
+            clockCounter = 0;
+            clockTick = true;
+        }
+
+        if (currentDelaySamples < targetDelaySamples) {
+            currentDelaySamples += delaySlewRate;
+            if (currentDelaySamples > targetDelaySamples) currentDelaySamples = targetDelaySamples;
+        } else if (currentDelaySamples > targetDelaySamples) {
+            currentDelaySamples -= delaySlewRate;
+            if (currentDelaySamples < targetDelaySamples) currentDelaySamples = targetDelaySamples;
+        }
+
+        int8_t delayedFiltered = lowpass8(interpolateRead(currentDelaySamples));
+        int16_t delayed12 = unpack8to12(delayedFiltered);
+
+        int32_t feedbackSignal = (delayed12 * (int16_t)feedbackAmount) >> 8;
+        int32_t mixedInput = input12 + feedbackSignal;
+        mixedInput = (mixedInput * 171) >> 8;
+        if (mixedInput > 2047) mixedInput = 2047;
+        if (mixedInput < -2048) mixedInput = -2048;
+
+        if (clockTick) {
+            buffer[writePos] = pack12to8((int16_t)mixedInput);
+            writePos++;
+            if (writePos >= bufferSize) writePos = 0;
+        }
+        return delayed12;
+    }
+
+    void setDelaySamples(uint32_t samples) {
+        uint32_t maxSamples = (bufferSize * clockDivider);
+        if (samples > maxSamples) samples = maxSamples;
+        if (samples < clockDivider) samples = clockDivider;
+        targetDelaySamples = samples << 16;
+    }
+
+    void setSlewRate(uint16_t rate) { delaySlewRate = rate; }
+    void setFeedback(uint8_t feedback) { feedbackAmount = feedback; }
+};
+
+// ---------------------------------------------------------------------------
+
+// RingBuffer against a plain SIZE-sample array written at a compare-wrapped
+// index, as the lines it replaced were
+template <class T, int Log2Size>
+static bool ring(const char* name)
+{
+    typedef RingBuffer<T, Log2Size> Ring;
+    const int SIZE = Ring::SIZE;
+    Ring r, direct;
+    T ref[SIZE];
+    memset(ref, 0, sizeof(ref));
+    int w = 0;
+    int bad = 0;
+    BenchRng rng;
+
+    for (int n = 0; n < 4 * SIZE + 3; n++) {
+        T v = (T)(rng.next12() >> (sizeof(T) == 1 ? 4 : 0));
+        r.push(v);
+        ref[w] = v;
+        if (++w >= SIZE) w = 0;
+
+        if (r.writePos() != (uint32_t)w) bad++;
+        for (int d = 1; d <= SIZE; d++) {
+            int p = w - d;
+            if (p < 0) p += SIZE;
+            if (r.tap(d) != ref[p] || r.tapPos(d) != (uint32_t)p || r.at(r.tapPos(d)) != ref[p]) bad++;
+        }
+
+        // Delay's per-sample read: position writeIdx - delay in Q8, the two
+        // samples either side, blended by the fraction
+        for (int32_t dQ8 = 256; dQ8 <= ((SIZE - 1) << 8); dQ8++) {
+            int32_t readPosQ8 = (w << 8) - dQ8;
+            if (readPosQ8 < 0) readPosQ8 += SIZE << 8;
+            int r0 = readPosQ8 >> 8;
+            int r1 = r0 + 1;
+            if (r1 >= SIZE) r1 = 0;
+            int32_t frac = readPosQ8 & 0xFF;
+            int32_t a = ref[r0];
+            if (r.tapQ8(dQ8) != a + (((ref[r1] - a) * frac) >> 8)) bad++;
+        }
+    }
+
+    // span(i) runs to the last slot of the array and no further
+    for (uint32_t i = 0; i < 3u * SIZE; i++) {
+        int s = Ring::span(i);
+        if (s < 1 || s > SIZE || r.slot(i) + s - 1 != &r.at(i + s - 1) || r.slot(i + s) != r.slot(0)) bad++;
+    }
+
+    // The same samples written in runs through slot() and advance()
+    BenchRng again;
+    int left = 4 * SIZE + 3;
+    while (left > 0) {
+        int run = 1 + (int)(again.s % 7);
+        uint32_t wi = direct.writePos();
+        if (run > Ring::span(wi)) run = Ring::span(wi);
+        if (run > left) run = left;
+        T* p = direct.slot(wi);
+        for (int i = 0; i < run; i++) p[i] = (T)(again.next12() >> (sizeof(T) == 1 ? 4 : 0));
+        direct.advance(run);
+        left -= run;
+    }
+    for (int d = 1; d <= SIZE; d++) {
+        if (direct.tap(d) != r.tap(d)) bad++;
+    }
+    if (direct.writePos() != r.writePos()) bad++;
+
+    printf("ring     %-8s %4d slots  %s\n", name, SIZE, bad ? "MISMATCH" : "identical");
+    return bad == 0;
+}
+
+// Knob for sample i: sweeping up and down over ~4 s
+static int knobAt(int i) { int k = (i / 24) & 8191; return k < 4096 ? k : 8191 - k; }
+
+static bool reverb()
+{
+    static constexpr int N = 20 * SR;
+    static constexpr int BLOCK = 16;
+    static int16_t in[N], outOld[N], outNew[N], outBlk[N];
+    static LegacyReverb legacy, legacyBlk;
+    static Reverb<> current, currentBlk;
+
+    // Noise bursts: 0.25 s on, 0.75 s off, so tails decay into silence too
+    BenchRng rng;
+    for (int i = 0; i < N; i++) in[i] = (i % SR) < SR / 4 ? rng.next12() : 0;
+
+    for (int i = 0; i < N; i++) outOld[i] = legacy.process(in[i], knobAt(i));
+    for (int i = 0; i < N; i++) outNew[i] = current.process(in[i], knobAt(i));
+    bool ok = !memcmp(outOld, outNew, sizeof(outOld));
+    printf("reverb   process()       20 s, knob sweeping  %s\n", ok ? "identical" : "MISMATCH");
+
+    // Block version: the knob read once a block, so the old one is fed the same
+    for (int i = 0; i < N; i++) outOld[i] = legacyBlk.process(in[i], knobAt(i - i % BLOCK));
+    for (int i = 0; i < N; i += BLOCK) currentBlk.processBlock(in + i, outBlk + i, BLOCK, knobAt(i));
+    bool okBlk = !memcmp(outOld, outBlk, sizeof(outOld));
+    printf("reverb   processBlock(%d) 20 s, knob sweeping  %s\n", BLOCK, okBlk ? "identical" : "MISMATCH");
+
+    double nsOld = benchNsPerSample([&] {
+        for (int i = 0; i < SR; i++) outOld[i] = legacy.process(in[i], 3072);
+        benchKeep(outOld);
+    }, SR);
+    double nsNew = benchNsPerSample([&] {
+        for (int i = 0; i < SR; i++) outNew[i] = current.process(in[i], 3072);
+        benchKeep(outNew);
+    }, SR);
+    printf("reverb   process() old %6.3f  ring %6.3f ns/sample  (%u -> %u bytes)\n", nsOld, nsNew,
+           (unsigned)sizeof(LegacyReverb), (unsigned)sizeof(Reverb<>));
+    return ok && okBlk;
+}
+
+template <uint32_t Stages>
+static bool bbd(uint16_t slew)
+{
+    static constexpr int N = 8 * SR;
+    static int16_t in[N], outOld[N], outNew[N];
+    std::unique_ptr<LegacyBbd> legacyLine(new LegacyBbd(2 * Stages));
+    std::unique_ptr<BucketBrigadeDelay<Stages, int8_t>> currentLine(new BucketBrigadeDelay<Stages, int8_t>);
+    LegacyBbd& legacy = *legacyLine;
+    BucketBrigadeDelay<Stages, int8_t>& current = *currentLine;
+    legacy.setSlewRate(slew);
+    current.setSlewRate(slew);
+
+    // Delay, feedback and slew moved every 3001 samples; delays run from
+    // under the minimum to past the end of the line
+    BenchRng rng;
+    for (int i = 0; i < N; i++) in[i] = rng.next12();
+    BenchRng ctl;
+    bool ok = true;
+    for (int i = 0; i < N; i++) {
+        if (i % 3001 == 0) {
+            uint32_t d = (ctl.s >> 8) % (2 * Stages + 64);
+            uint8_t fb = (uint8_t)(ctl.next12() & 0xFF);
+            legacy.setDelaySamples(d);
+            current.setDelaySamples(d);
+            legacy.setFeedback(fb);
+            current.setFeedback(fb);
+        }
+        outOld[i] = legacy.process(in[i]);
+        outNew[i] = current.process(in[i]);
+        if (outOld[i] != outNew[i]) ok = false;
+    }
+
+    legacy.setDelaySamples(Stages);
+    current.setDelaySamples(Stages);
+    double nsOld = benchNsPerSample([&] {
+        for (int i = 0; i < SR; i++) outOld[i] = legacy.process(in[i]);
+        benchKeep(outOld);
+    }, SR);
+    double nsNew = benchNsPerSample([&] {
+        for (int i = 0; i < SR; i++) outNew[i] = current.process(in[i]);
+        benchKeep(outNew);
+    }, SR);
+    printf("bbd      %5u stages, slew %5u  %-9s  process() old %6.3f  ring %6.3f ns/sample\n",
+           Stages, slew, ok ? "identical" : "MISMATCH", nsOld, nsNew);
+    return ok;
+}
+
+int main()
+{
+    bool ok = ring<int16_t, 5>("int16_t");
+    ok = ring<int8_t, 4>("int8_t") && ok;
+    ok = reverb() && ok;
+    ok = bbd<32767>(100) && ok;
+    ok = bbd<32767>(20000) && ok;
+    ok = bbd<3000>(100) && ok;
+    ok = bbd<64>(100) && ok;
+    if (!ok) printf("FAIL: output differs from the code RingBuffer replaced\n");
+    return ok ? 0 : 1;
+}
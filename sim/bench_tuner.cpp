@@ -0,0 +1,306 @@
+// Host benchmark: YinPitchDetector against the zero-crossing PitchDetector.
+//
+// Each detector hears 1.5 s of a test tone — sine, band-limited saw, square
+// and 10% pulse, and a sine with a strong third harmonic, which crosses zero
+// three times a period — at 24 pitches from 20 Hz to 4 kHz, each detuned
+// from equal temperament by a different amount, with a little noise.  Every
+// 10 ms the reported period is compared with the true one:
+//
+//   lock     time until the estimate is first within 25 cents
+//   octave   share of estimates after 0.5 s more than 600 cents out
+//            (locked to a harmonic or subharmonic), or missing
+//   jitter   rms deviation in cents of the remaining settled estimates
+//   bias     worst mean error in cents over the pitches, settled estimates
+//
+// Then it times addSample, and YinPitchDetector::update amortised over the
+// samples it covers, at a few pitches; and for the longest searches — a
+// 20 Hz saw, and noise, where every lag is tried — the longest single
+// update() call against the whole search it is a slice of.
+//
+// Last, period-to-cents: periodQ8ToCOffset over every Q8 period from 20 Hz
+// to 4 kHz against the exact value, and the closeness the LEDs are driven
+// from, old (division, octave loops and a first-order log) against new.
+// Exits 1 if the new conversion, or the closeness from it, is out by 0.5
+// cents or more anywhere.
+
+#include "Tuner.h"
+#include "bench.h"
+#include <math.h>
+
+static constexpr int SR      = 48000;
+static constexpr int LEN     = SR * 3 / 2;
+static constexpr int STEP    = SR / 100;     // compare every 10 ms
+static constexpr int SETTLED = SR / 2;
+static constexpr int PITCHES = 24;
+
+enum Shape { SINE, SAW, SQUARE, PULSE, THIRD, SHAPES };
+static const char* SHAPE_NAMES[SHAPES] = { "sine", "saw", "square", "pulse", "sine+3rd" };
+
+static int16_t sig[LEN];
+
+// PolyBLEP correction for a step at phase 0 (t in cycles, dt per sample)
+static double blep(double t, double dt)
+{
+    if (t < dt)       { t /= dt;             return t + t - t * t - 1.0; }
+    if (t > 1.0 - dt) { t = (t - 1.0) / dt;  return t * t + t + t + 1.0; }
+    return 0.0;
+}
+
+static void makeSignal(Shape shape, double hz)
+{
+    BenchRng rng;
+    const double dt = hz / SR;
+    double t = 0.0;
+    for (int i = 0; i < LEN; i++) {
+        double v = 0.0;
+        switch (shape) {
+        case SINE:   v = sin(2.0 * M_PI * t); break;
+        case SAW:    v = 2.0 * t - 1.0 - blep(t, dt); break;
+        case SQUARE:
+        case PULSE: {
+            double w = (shape == SQUARE) ? 0.5 : 0.1;
+            double u = t + 1.0 - w;
+            if (u >= 1.0) u -= 1.0;
+            v = (t < w ? 1.0 : -1.0) + blep(t, dt) - blep(u, dt);
+            if (shape == PULSE) v += 1.0 - 2.0 * w;    // remove DC
+            break;
+        }
+        case THIRD:  v = 0.55 * sin(2.0 * M_PI * t) + 0.45 * sin(6.0 * M_PI * t); break;
+        default: break;
+        }
+        sig[i] = (int16_t)lround(1500.0 * v) + (rng.next12() >> 8);
+        t += dt;
+        if (t >= 1.0) t -= 1.0;
+    }
+}
+
+struct Score {
+    double lockMs = 0.0;
+    int    locked = 0, unlocked = 0;
+    int    octave = 0, settled = 0;
+    double sq = 0.0;
+    int    n = 0;
+    double worstBias = 0.0;
+};
+
+// Runs one detector over sig[]; period() gives the period in samples at 48 kHz
+template <class D, class Period>
+static void score(D& d, Period period, double hz, Score& s)
+{
+    d = D();
+    int lockAt = -1;
+    double sum = 0.0;
+    int n = 0;
+    for (int i = 0; i < LEN; i++) {
+        d.addSample(sig[i]);
+        if constexpr (sizeof(D) == sizeof(YinPitchDetector)) d.update();
+        if ((i + 1) % STEP) continue;
+        double p = period(d);
+        double cents = p > 0.0 ? 1200.0 * log2(SR / p / hz) : 1e9;
+        if (lockAt < 0 && fabs(cents) < 25.0) lockAt = i + 1;
+        if (i + 1 < SETTLED) continue;
+        s.settled++;
+        if (fabs(cents) > 600.0) { s.octave++; continue; }
+        sum += cents;
+        s.sq += cents * cents;
+        n++;
+    }
+    if (lockAt < 0) s.unlocked++;
+    else { s.locked++; s.lockMs += lockAt * 1000.0 / SR; }
+    if (n) {
+        double bias = sum / n;
+        s.sq -= bias * bias * n;   // jitter about this pitch's own mean
+        if (fabs(bias) > fabs(s.worstBias)) s.worstBias = bias;
+        s.n += n;
+    }
+}
+
+static void print(const char* det, const char* shape, const Score& s)
+{
+    printf("%-6s %-9s lock %6.1f ms", det, shape, s.locked ? s.lockMs / s.locked : 0.0);
+    if (s.unlocked) printf(" (%2d never)", s.unlocked);
+    else            printf("           ");
+    printf("  octave %5.1f %%  jitter %6.2f cents  bias %+7.2f cents\n",
+           100.0 * s.octave / s.settled, s.n ? sqrt(s.sq / s.n) : 0.0, s.worstBias);
+}
+
+static void add(Score& to, const Score& s)
+{
+    to.lockMs  += s.lockMs;
+    to.locked  += s.locked;
+    to.unlocked += s.unlocked;
+    to.octave  += s.octave;
+    to.settled += s.settled;
+    to.sq      += s.sq;
+    to.n       += s.n;
+    if (fabs(s.worstBias) > fabs(to.worstBias)) to.worstBias = s.worstBias;
+}
+
+// The octave-reducing, first-order-log conversion periodToCloseness used
+// before the log2 table, for comparison
+static int16_t legacyPeriodToCloseness(uint32_t period_samples)
+{
+    if (period_samples == 0) return INT16_MIN;
+    uint32_t f = 48000000UL / period_samples;
+    const uint32_t C4 = 261626;
+    const uint32_t C5 = 523251;
+    while (f < C4) f <<= 1;
+    while (f >= C5) f >>= 1;
+    int32_t cents;
+    if (f >= 370000UL) cents = -(int32_t)((C5 - f) * 1731UL / C5);
+    else               cents = (int32_t)((f - C4) * 1731UL / C4);
+    int32_t out = cents * 2047L / 600;
+    if (out >  2047) out =  2047;
+    if (out < -2047) out = -2047;
+    return (int16_t)out;
+}
+
+// Exact cents from the nearest C for a period in samples
+static double exactCents(double period)
+{
+    double c = 1200.0 * log2(SR / period / 261.6255653);
+    c -= 1200.0 * floor(c / 1200.0 + 0.5);
+    return c;
+}
+
+// Returns false if periodQ8ToCOffset or periodQ8ToCloseness is out by 0.5
+// cents or more
+static bool cents()
+{
+    const uint32_t lo = (SR << 8) / 4000, hi = (SR << 8) / 20;
+    double worstOffset = 0.0, worstNew = 0.0, worstOld = 0.0;
+    for (uint32_t p = lo; p <= hi; p++) {
+        double exact = exactCents(p / 256.0);
+        if (fabs(exact) > 599.0) continue;   // either side of the fold is right
+        double e = periodQ8ToCOffset(p) * (1200.0 / 65536.0) - exact;
+        if (fabs(e) > worstOffset) worstOffset = fabs(e);
+        e = periodQ8ToCloseness(p) * (600.0 / 2047.0) - exact;
+        if (fabs(e) > worstNew) worstNew = fabs(e);
+        if ((p & 255) == 0) {
+            e = legacyPeriodToCloseness(p >> 8) * (600.0 / 2047.0) - exact;
+            if (fabs(e) > worstOld) worstOld = fabs(e);
+        }
+    }
+    printf("cents    periodQ8ToCOffset worst error %6.3f cents\n", worstOffset);
+    printf("cents    closeness         worst error %6.3f cents  (legacy %6.2f cents, whole periods)\n",
+           worstNew, worstOld);
+
+    static uint32_t periods[4096];
+    static int16_t  out[4096];
+    for (int i = 0; i < 4096; i++) periods[i] = lo + (uint32_t)i * ((hi - lo) / 4096);
+    double newNs = benchNsPerSample([&] {
+        for (int i = 0; i < 4096; i++) out[i] = periodQ8ToCloseness(periods[i]);
+        benchKeep(out);
+    }, 4096);
+    double oldNs = benchNsPerSample([&] {
+        for (int i = 0; i < 4096; i++) out[i] = legacyPeriodToCloseness(periods[i] >> 8);
+        benchKeep(out);
+    }, 4096);
+    printf("cents    periodQ8ToCloseness %6.3f ns/call  legacy %6.3f ns/call\n", newNs, oldNs);
+
+    if (worstOffset >= 0.5 || worstNew >= 0.5) {
+        printf("FAIL: period to cents out by 0.5 cents or more\n");
+        return false;
+    }
+    return true;
+}
+
+// Longest update() call and longest whole search, each the best of three
+// runs over sig[], and the most calls a search took
+static void slices(YinPitchDetector& yin, const char* name)
+{
+    double worstCall = 1e30, worstSearch = 1e30;
+    int worstCalls = 0;
+    for (int run = 0; run < 3; run++) {
+        double callMax = 0.0, searchMax = 0.0, searchNs = 0.0;
+        int calls = 0;
+        yin = YinPitchDetector();
+        for (int i = 0; i < LEN; i++) {
+            yin.addSample(sig[i]);
+            bool was = yin.searching();
+            auto t0 = std::chrono::steady_clock::now();
+            bool done = yin.update();
+            double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now() - t0).count();
+            if (!was && !yin.searching() && !done) continue;     // nothing to do
+            if (ns > callMax) callMax = ns;
+            searchNs += ns;
+            calls++;
+            if (!yin.searching()) {
+                if (searchNs > searchMax) searchMax = searchNs;
+                if (calls > worstCalls) worstCalls = calls;
+                searchNs = 0.0;
+                calls = 0;
+            }
+        }
+        if (callMax < worstCall) worstCall = callMax;
+        if (searchMax < worstSearch) worstSearch = searchMax;
+    }
+    printf("%-9s update longest call %7.2f us, longest search %8.2f us over up to %d calls\n",
+           name, worstCall / 1000.0, worstSearch / 1000.0, worstCalls);
+}
+
+int main()
+{
+    static PitchDetector zc;
+    static YinPitchDetector yin;
+    auto zcPeriod  = [](const PitchDetector& d) { return d.periodQ8() / 256.0; };
+    auto yinPeriod = [](const YinPitchDetector& d) { return d.periodQ8() / 256.0; };
+
+    double hz[PITCHES];
+    for (int k = 0; k < PITCHES; k++) {
+        double detune = ((k * 37) % 41 - 20) * 1.1;    // -22..+22 cents
+        hz[k] = 20.0 * pow(200.0, k / (PITCHES - 1.0)) * pow(2.0, detune / 1200.0);
+        if (hz[k] > 4000.0) hz[k] = 4000.0;
+        if (hz[k] < 20.0)   hz[k] = 20.0;
+    }
+
+    Score allZc, allYin;
+    for (int sh = 0; sh < SHAPES; sh++) {
+        Score sZc, sYin;
+        for (int k = 0; k < PITCHES; k++) {
+            makeSignal((Shape)sh, hz[k]);
+            score(zc,  zcPeriod,  hz[k], sZc);
+            score(yin, yinPeriod, hz[k], sYin);
+        }
+        print("zc",  SHAPE_NAMES[sh], sZc);
+        print("yin", SHAPE_NAMES[sh], sYin);
+        add(allZc, sZc);
+        add(allYin, sYin);
+    }
+    print("zc",  "all", allZc);
+    print("yin", "all", allYin);
+
+    // CPU: addSample on its own, and update() per input sample it covers
+    static const double TIMED_HZ[] = { 20.0, 110.0, 440.0, 1760.0 };
+    for (double f : TIMED_HZ) {
+        makeSignal(SAW, f);
+        double zcNs = benchNsPerSample([&] {
+            for (int i = 0; i < LEN; i++) zc.addSample(sig[i]);
+            benchKeep(zc);
+        }, LEN);
+        double addNs = benchNsPerSample([&] {
+            for (int i = 0; i < LEN; i++) yin.addSample(sig[i]);
+            benchKeep(yin);
+        }, LEN);
+        // Analyses only: refill the ring, then run update() once per HOP
+        double updNs = benchNsPerSample([&] {
+            yin = YinPitchDetector();
+            for (int i = 0; i < LEN; i++) {
+                yin.addSample(sig[i]);
+                yin.update();
+            }
+            benchKeep(yin);
+        }, LEN, 3) - addNs;
+        printf("%6.0f Hz  zc addSample %6.3f ns/sample  yin addSample %6.3f ns/sample  update %7.3f ns/sample\n",
+               f, zcNs, addNs, updNs);
+    }
+
+    makeSignal(SAW, 20.0);
+    slices(yin, "20 Hz saw");
+    BenchRng rng;
+    for (int i = 0; i < LEN; i++) sig[i] = rng.next12();
+    slices(yin, "noise");
+
+    return cents() ? 0 : 1;
+}
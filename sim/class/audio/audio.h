@@ -0,0 +1 @@
+// Empty: TinyUSB class header not needed by the simulator.
@@ -0,0 +1,18 @@
+#ifndef SIM_HARDWARE_ADC_H
+#define SIM_HARDWARE_ADC_H
+
+#include "pico.h"
+
+// Cards only use the ADC directly to gather seed noise from the temperature
+// sensor; return a fixed LCG sequence so runs are reproducible.
+static inline void adc_init() {}
+static inline void adc_set_temp_sensor_enabled(bool) {}
+static inline void adc_select_input(uint) {}
+static inline uint16_t adc_read()
+{
+    static uint32_t seed = 12345;
+    seed = 1664525 * seed + 1013904223;
+    return (uint16_t)(seed >> 20);
+}
+
+#endif
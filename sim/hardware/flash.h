@@ -0,0 +1,23 @@
+#ifndef SIM_HARDWARE_FLASH_H
+#define SIM_HARDWARE_FLASH_H
+
+#include "pico.h"
+#include <string.h>
+
+#define FLASH_PAGE_SIZE   (1u << 8)
+#define FLASH_SECTOR_SIZE (1u << 12)
+#define FLASH_BLOCK_SIZE  (1u << 16)
+
+// Same semantics as the ROM routines: erase sets bytes to 0xFF, program can
+// only clear bits.
+static inline void flash_range_erase(uint32_t offset, size_t count)
+{
+    memset(sim_flash + offset, 0xFF, count);
+}
+
+static inline void flash_range_program(uint32_t offset, const uint8_t* data, size_t count)
+{
+    for (size_t i = 0; i < count; i++) sim_flash[offset + i] &= data[i];
+}
+
+#endif
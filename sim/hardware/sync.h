@@ -0,0 +1,11 @@
+#ifndef SIM_HARDWARE_SYNC_H
+#define SIM_HARDWARE_SYNC_H
+
+#include "pico.h"
+#include <atomic>
+
+static inline uint32_t save_and_disable_interrupts() { return 0; }
+static inline void restore_interrupts(uint32_t) {}
+static inline void __dmb() { std::atomic_thread_fence(std::memory_order_seq_cst); }
+
+#endif
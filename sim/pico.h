@@ -0,0 +1,30 @@
+#ifndef SIM_PICO_H
+#define SIM_PICO_H
+
+// Minimal host replacement for the Pico SDK base header.
+//
+// Flash is a RAM array owned by the simulator; XIP_BASE points at it so the
+// cards' memory-mapped flash reads (XIP_BASE + offset) work unchanged.
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef unsigned int uint;
+
+#ifndef PICO_FLASH_SIZE_BYTES
+#define PICO_FLASH_SIZE_BYTES (2 * 1024 * 1024)
+#endif
+
+extern uint8_t sim_flash[PICO_FLASH_SIZE_BYTES];
+#define XIP_BASE ((uintptr_t)sim_flash)
+
+// Services implemented in sim.cpp for the stub SDK headers.
+void sim_sleep_us(uint64_t us);
+void sim_core0_idle();
+void sim_launch_core1(void (*entry)(void));
+void sim_lockout_start();
+void sim_lockout_end();
+uint32_t sim_midi_available();
+uint32_t sim_midi_read(uint8_t* buf, uint32_t bufsize);
+
+#endif
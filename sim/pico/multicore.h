@@ -0,0 +1,13 @@
+#ifndef SIM_PICO_MULTICORE_H
+#define SIM_PICO_MULTICORE_H
+
+#include "pico.h"
+
+// Core 1 is a host thread run in lockstep with core 0 (see sim.cpp), so
+// lockout only has to stop simulated time.
+static inline void multicore_launch_core1(void (*entry)(void)) { sim_launch_core1(entry); }
+static inline void multicore_lockout_victim_init() {}
+static inline void multicore_lockout_start_blocking() { sim_lockout_start(); }
+static inline void multicore_lockout_end_blocking() { sim_lockout_end(); }
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef SIM_PICO_STDLIB_H
+#define SIM_PICO_STDLIB_H
+
+#include "pico.h"
+
+// Sleeps are measured in simulated time: the caller waits until the audio
+// loop has advanced by the requested number of samples.  A busy-wait loop
+// on core 0 marks itself with tight_loop_contents(), which lets the audio
+// loop run for a millisecond.
+static inline void sleep_us(uint64_t us) { sim_sleep_us(us); }
+static inline void sleep_ms(uint32_t ms) { sim_sleep_us((uint64_t)ms * 1000u); }
+
+static inline bool set_sys_clock_khz(uint32_t, bool) { return true; }
+static inline void tight_loop_contents() { sim_core0_idle(); }
+static inline bool stdio_init_all() { return true; }
+
+#endif
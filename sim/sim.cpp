@@ -0,0 +1,564 @@
+// Host simulator for ComputerCard cards.
+//
+// Each card's main.cpp is compiled with -Dmain=card_main and linked with this
+// file, which provides the real main(), ComputerCard::Run() and the services
+// behind the stub SDK headers (flash, sleeps, second core, USB MIDI).
+//
+// Run() feeds ProcessSample() from WAV files and a scripted control timeline,
+// one call per 48 kHz sample with no real-time pacing, and captures every
+// output.  When the timeline ends it writes WAV/CSV files, prints the time
+// spent per sample and exits — Run() never returns, as on hardware.
+//
+// Cards that put audio on core 1 (soz, vss) get a host thread for it, run in
+// lockstep with their core 0 loop on the main thread so that results are
+// repeatable.  sleep_ms() waits in simulated time.
+//
+// See README.md for the command line and script format.
+
+#include "ComputerCard.h"
+#include "pico/stdlib.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <string>
+#include <thread>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int card_main();
+
+uint8_t sim_flash[PICO_FLASH_SIZE_BYTES];
+ComputerCard* ComputerCard::thisptr = nullptr;
+
+static constexpr uint32_t SAMPLE_RATE = 48000;
+
+// ===========================================================
+// Command line / script state
+// ===========================================================
+
+namespace {
+
+enum Control : uint8_t {
+    C_KNOB, C_SWITCH, C_AUDIO, C_CV, C_PULSE, C_CLOCK, C_CONNECT, C_MIDI
+};
+
+struct Event {
+    uint64_t time;          // sample index
+    Control  control;
+    int      index;         // knob / input / jack number
+    int32_t  value;
+    std::vector<uint8_t> midi;
+};
+
+struct Track {
+    std::vector<int16_t> samples;   // 12-bit signed
+    bool present = false;
+};
+
+struct Snapshot {
+    uint64_t sample;
+    int16_t  audioOut[2], cvOut[2];
+    bool     pulseOut[2];
+    uint16_t leds[6];
+};
+
+struct Options {
+    const char* audioIn[2]  = { nullptr, nullptr };
+    const char* cvIn[2]     = { nullptr, nullptr };
+    const char* script      = nullptr;
+    const char* out         = nullptr;
+    const char* cvOut       = nullptr;
+    const char* csv         = nullptr;
+    const char* flash       = nullptr;
+    uint32_t    csvEvery    = 48;
+    uint64_t    samples     = 0;     // 0 = derive from inputs
+    bool        quiet       = false;
+};
+
+Options            opts;
+Track              audioTracks[2], cvTracks[2];
+std::vector<Event> events;
+bool               scriptConnects[6];
+
+// ---- Core 0 / core 1 lockstep ----
+//
+// Only one of the two "cores" runs at a time.  Core 0 holds the baton until
+// it reaches an idle point (tight_loop_contents, tud_task, a sleep), then the
+// audio loop runs until core 0's wake time — at most CORE0_QUANTUM samples,
+// one 1 ms USB frame — and hands it back.  This keeps multicore cards
+// deterministic regardless of host scheduling.
+enum Turn { CORE0, AUDIO };
+static constexpr uint64_t CORE0_QUANTUM = SAMPLE_RATE / 1000;
+
+std::atomic<bool>     multicore(false);
+std::atomic<int>      turn(CORE0);
+std::atomic<uint64_t> simTime(0);
+std::atomic<uint64_t> core0WakeAt(0);
+std::atomic<bool>     lockoutHeld(false);
+std::thread::id       audioThread;
+
+std::deque<uint8_t>   midiQueue;      // only touched by the baton holder
+
+void fail(const char* fmt, const char* arg, int line = 0)
+{
+    fprintf(stderr, "sim: ");
+    if (line) fprintf(stderr, "%s:%d: ", opts.script, line);
+    fprintf(stderr, fmt, arg);
+    fprintf(stderr, "\n");
+    exit(1);
+}
+
+// ===========================================================
+// WAV I/O
+// ===========================================================
+
+uint32_t rd32(const uint8_t* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24); }
+uint16_t rd16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+
+// Load the first channel of a PCM (8/16/24/32-bit) or float WAV as 12-bit
+// signed samples.  No resampling: a rate other than 48 kHz only warns.
+void loadWav(const char* path, Track& track)
+{
+    FILE* f = fopen(path, "rb");
+    if (!f) fail("cannot open %s", path);
+    std::vector<uint8_t> d;
+    uint8_t chunk[65536];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) d.insert(d.end(), chunk, chunk + n);
+    fclose(f);
+
+    if (d.size() < 12 || memcmp(&d[0], "RIFF", 4) || memcmp(&d[8], "WAVE", 4))
+        fail("%s is not a WAV file", path);
+
+    uint16_t format = 0, channels = 0, bits = 0;
+    uint32_t rate = 0;
+    size_t pos = 12;
+    while (pos + 8 <= d.size()) {
+        uint32_t len = rd32(&d[pos + 4]);
+        const uint8_t* body = &d[pos + 8];
+        if (pos + 8 + len > d.size()) len = (uint32_t)(d.size() - pos - 8);
+
+        if (!memcmp(&d[pos], "fmt ", 4) && len >= 16) {
+            format   = rd16(body);
+            channels = rd16(body + 2);
+            rate     = rd32(body + 4);
+            bits     = rd16(body + 14);
+            if (format == 0xFFFE && len >= 26) format = rd16(body + 24);  // WAVE_FORMAT_EXTENSIBLE
+        } else if (!memcmp(&d[pos], "data", 4)) {
+            if (!channels || !bits) fail("%s: data before fmt chunk", path);
+            if (!(format == 1 && (bits == 8 || bits == 16 || bits == 24 || bits == 32)) &&
+                !(format == 3 && bits == 32))
+                fail("%s: unsupported sample format", path);
+            if (rate != SAMPLE_RATE)
+                fprintf(stderr, "sim: warning: %s is %u Hz, played at 48 kHz\n", path, rate);
+
+            uint32_t frameBytes = channels * (bits / 8u);
+            uint32_t frames     = len / frameBytes;
+            track.samples.resize(frames);
+            for (uint32_t i = 0; i < frames; i++) {
+                const uint8_t* s = body + (size_t)i * frameBytes;
+                int32_t v;
+                if (format == 3) {
+                    float x;
+                    memcpy(&x, s, 4);
+                    v = (int32_t)(x * 2048.0f);
+                } else if (bits == 8)  v = ((int32_t)s[0] - 128) << 4;
+                else if (bits == 16)   v = (int16_t)rd16(s) >> 4;
+                else if (bits == 24)   v = ((int32_t)((uint32_t)s[0] << 8 | (uint32_t)s[1] << 16 | (uint32_t)s[2] << 24)) >> 20;
+                else                   v = (int32_t)rd32(s) >> 20;
+                if (v < -2048) v = -2048;
+                if (v >  2047) v =  2047;
+                track.samples[i] = (int16_t)v;
+            }
+            track.present = true;
+            return;
+        }
+        pos += 8 + len + (len & 1);
+    }
+    fail("%s: no data chunk", path);
+}
+
+void wr32(FILE* f, uint32_t v) { uint8_t b[4] = { (uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24) }; fwrite(b, 1, 4, f); }
+void wr16(FILE* f, uint16_t v) { uint8_t b[2] = { (uint8_t)v, (uint8_t)(v >> 8) }; fwrite(b, 1, 2, f); }
+
+// Write interleaved stereo 12-bit samples as 16-bit PCM at 48 kHz.
+void saveWav(const char* path, const std::vector<int16_t>& lr)
+{
+    FILE* f = fopen(path, "wb");
+    if (!f) fail("cannot write %s", path);
+    uint32_t dataBytes = (uint32_t)lr.size() * 2u;
+    fwrite("RIFF", 1, 4, f); wr32(f, 36 + dataBytes); fwrite("WAVE", 1, 4, f);
+    fwrite("fmt ", 1, 4, f); wr32(f, 16);
+    wr16(f, 1); wr16(f, 2); wr32(f, SAMPLE_RATE); wr32(f, SAMPLE_RATE * 4); wr16(f, 4); wr16(f, 16);
+    fwrite("data", 1, 4, f); wr32(f, dataBytes);
+    for (int16_t s : lr) wr16(f, (uint16_t)(int16_t)(s * 16));
+    fclose(f);
+}
+
+// ===========================================================
+// Script parsing
+// ===========================================================
+
+int inputIndex(const char* name)
+{
+    static const char* names[6] = { "audio1", "audio2", "cv1", "cv2", "pulse1", "pulse2" };
+    for (int i = 0; i < 6; i++) if (!strcmp(name, names[i])) return i;
+    return -1;
+}
+
+// "12000" = sample index, "1.5s" / "250ms" = time
+bool parseTime(const char* s, uint64_t& out)
+{
+    char* end;
+    double v = strtod(s, &end);
+    if (end == s || v < 0) return false;
+    if (!*end)               out = (uint64_t)v;
+    else if (!strcmp(end, "s"))  out = (uint64_t)(v * SAMPLE_RATE + 0.5);
+    else if (!strcmp(end, "ms")) out = (uint64_t)(v * (SAMPLE_RATE / 1000) + 0.5);
+    else return false;
+    return true;
+}
+
+bool parseInt(const char* s, int32_t lo, int32_t hi, int32_t& out)
+{
+    char* end;
+    long v = strtol(s, &end, 0);
+    if (end == s || *end || v < lo || v > hi) return false;
+    out = (int32_t)v;
+    return true;
+}
+
+void loadScript(const char* path)
+{
+    FILE* f = fopen(path, "r");
+    if (!f) fail("cannot open %s", path);
+    char line[1024];
+    int lineNo = 0;
+    while (fgets(line, sizeof(line), f)) {
+        lineNo++;
+        char* hash = strchr(line, '#');
+        if (hash) *hash = 0;
+
+        std::vector<char*> tok;
+        for (char* t = strtok(line, " \t\r\n"); t; t = strtok(nullptr, " \t\r\n")) tok.push_back(t);
+        if (tok.empty()) continue;
+        if (tok.size() < 3) fail("expected '<time> <control> <value>'", "", lineNo);
+
+        Event e;
+        if (!parseTime(tok[0], e.time)) fail("bad time '%s'", tok[0], lineNo);
+        const char* c = tok[1];
+        const char* v = tok[2];
+        e.index = 0;
+        e.value = 0;
+
+        if (!strcmp(c, "main") || !strcmp(c, "x") || !strcmp(c, "y")) {
+            e.control = C_KNOB;
+            e.index   = c[0] == 'm' ? ComputerCard::Main : c[0] == 'x' ? ComputerCard::X : ComputerCard::Y;
+            if (!parseInt(v, 0, 4095, e.value)) fail("knob value '%s' not in 0..4095", v, lineNo);
+        } else if (!strcmp(c, "switch")) {
+            e.control = C_SWITCH;
+            if      (!strcmp(v, "up"))     e.value = ComputerCard::Up;
+            else if (!strcmp(v, "middle")) e.value = ComputerCard::Middle;
+            else if (!strcmp(v, "down"))   e.value = ComputerCard::Down;
+            else fail("switch position '%s' not up/middle/down", v, lineNo);
+        } else if (!strcmp(c, "connect") || !strcmp(c, "disconnect")) {
+            e.control = C_CONNECT;
+            e.index   = inputIndex(v);
+            e.value   = c[0] == 'c';
+            if (e.index < 0) fail("unknown input '%s'", v, lineNo);
+        } else if (!strcmp(c, "midi")) {
+            e.control = C_MIDI;
+            for (size_t i = 2; i < tok.size(); i++) {
+                int32_t b;
+                char hex[16];
+                snprintf(hex, sizeof(hex), "0x%s", tok[i]);
+                if (!parseInt(hex, 0, 255, b)) fail("bad MIDI byte '%s'", tok[i], lineNo);
+                e.midi.push_back((uint8_t)b);
+            }
+        } else {
+            e.index = inputIndex(c);
+            if (e.index < 0) fail("unknown control '%s'", c, lineNo);
+            scriptConnects[e.index] = true;
+            if (e.index >= ComputerCard::Pulse1) {
+                e.index -= ComputerCard::Pulse1;
+                if (!strcmp(v, "every")) {
+                    uint64_t period;
+                    if (tok.size() < 4 || !parseTime(tok[3], period) || period < 2)
+                        fail("'every' needs a period of at least 2 samples", "", lineNo);
+                    e.control = C_CLOCK;
+                    e.value   = (int32_t)period;
+                } else {
+                    e.control = C_PULSE;
+                    if (!parseInt(v, 0, 1, e.value)) fail("pulse value '%s' not 0/1/every", v, lineNo);
+                }
+            } else {
+                e.control = e.index >= ComputerCard::CV1 ? C_CV : C_AUDIO;
+                e.index  &= 1;
+                if (!parseInt(v, -2048, 2047, e.value)) fail("value '%s' not in -2048..2047", v, lineNo);
+            }
+        }
+        events.push_back(e);
+    }
+    fclose(f);
+
+    // Stable: same-time events apply in file order
+    std::stable_sort(events.begin(), events.end(),
+                     [](const Event& a, const Event& b) { return a.time < b.time; });
+}
+
+void usage()
+{
+    fprintf(stderr,
+        "usage: sim_<card> [options]\n"
+        "  --in1 FILE, --in2 FILE   WAV for Audio In 1/2\n"
+        "  --cv1 FILE, --cv2 FILE   WAV for CV In 1/2\n"
+        "  --script FILE            control timeline (knobs, switch, pulses, MIDI)\n"
+        "  --seconds S | --samples N  run length (default: longest input WAV or script, min 1 s)\n"
+        "  --out FILE               stereo WAV of Audio Out 1/2\n"
+        "  --cv-out FILE            stereo WAV of CV Out 1/2\n"
+        "  --csv FILE               CSV of all outputs and LEDs\n"
+        "  --csv-every N            CSV row every N samples (default 48 = 1 ms)\n"
+        "  --flash FILE             flash image, loaded if present and saved at exit\n"
+        "  --quiet                  no timing report\n");
+    exit(1);
+}
+
+} // namespace
+
+// ===========================================================
+// Services behind the stub SDK headers
+// ===========================================================
+
+// Called on core 0: let the audio loop run for `samples`, then resume.
+// While core 0 holds the audio core in lockout, simulated time stands still.
+static void core0Idle(uint64_t samples)
+{
+    if (!multicore || lockoutHeld || std::this_thread::get_id() == audioThread) return;
+    core0WakeAt = simTime + (samples ? samples : 1);
+    turn = AUDIO;
+    while (turn != CORE0) std::this_thread::yield();
+}
+
+void sim_sleep_us(uint64_t us) { core0Idle(us * SAMPLE_RATE / 1000000u); }
+void sim_core0_idle()          { core0Idle(CORE0_QUANTUM); }
+
+void sim_launch_core1(void (*entry)(void))
+{
+    multicore = true;
+    std::thread(entry).detach();
+}
+
+// Core 0 already holds the baton, so core 1 is parked between samples.
+void sim_lockout_start() { lockoutHeld = true; }
+void sim_lockout_end()   { lockoutHeld = false; }
+
+uint32_t sim_midi_available()
+{
+    return (uint32_t)midiQueue.size();
+}
+
+uint32_t sim_midi_read(uint8_t* buf, uint32_t bufsize)
+{
+    uint32_t n = 0;
+    while (n < bufsize && !midiQueue.empty()) { buf[n++] = midiQueue.front(); midiQueue.pop_front(); }
+    return n;
+}
+
+extern "C" uint32_t tuh_midi_stream_read(uint8_t, uint8_t*, uint8_t*, uint16_t) { return 0; }
+
+// ===========================================================
+// ComputerCard
+// ===========================================================
+
+ComputerCard::ComputerCard()
+{
+    for (int i = 0; i < 2; i++) {
+        audioIn[i] = cvIn[i] = audioOut[i] = cvOut[i] = 0;
+        pulseIn[i] = lastPulseIn[i] = pulseOut[i] = false;
+    }
+    for (int i = 0; i < 3; i++) knobs[i] = 2048;
+    for (int i = 0; i < 6; i++) leds[i] = 0;
+    switchVal = lastSwitchVal = Middle;
+    useNormProbe = false;
+
+    // Inputs with a WAV or any scripted value start connected; the script
+    // can still connect/disconnect them at any time.
+    for (int i = 0; i < 6; i++) connected[i] = scriptConnects[i];
+    for (int i = 0; i < 2; i++) {
+        if (audioTracks[i].present) connected[Audio1 + i] = true;
+        if (cvTracks[i].present)    connected[CV1 + i]    = true;
+    }
+}
+
+void ComputerCard::Run()
+{
+    thisptr     = this;
+    audioThread = std::this_thread::get_id();
+
+    std::vector<int16_t>  audioOutBuf, cvOutBuf;
+    std::vector<Snapshot> rows;
+    if (opts.out)   audioOutBuf.reserve(opts.samples * 2);
+    if (opts.cvOut) cvOutBuf.reserve(opts.samples * 2);
+    if (opts.csv)   rows.reserve(opts.samples / opts.csvEvery + 1);
+
+    int16_t  heldAudio[2] = { 0, 0 }, heldCV[2] = { 0, 0 };
+    uint64_t clockPeriod[2] = { 0, 0 }, clockStart[2] = { 0, 0 };
+    size_t   ev = 0;
+
+    int64_t core0Ns = 0;
+    if (multicore)
+        while (turn != AUDIO) std::this_thread::yield();
+
+    auto t0 = std::chrono::steady_clock::now();
+
+    for (uint64_t n = 0; n < opts.samples; n++) {
+        lastSwitchVal  = switchVal;
+        lastPulseIn[0] = pulseIn[0];
+        lastPulseIn[1] = pulseIn[1];
+
+        for (; ev < events.size() && events[ev].time <= n; ev++) {
+            const Event& e = events[ev];
+            switch (e.control) {
+            case C_KNOB:    knobs[e.index] = (int16_t)e.value; break;
+            case C_SWITCH:  switchVal = (Switch)e.value; break;
+            case C_AUDIO:   heldAudio[e.index] = (int16_t)e.value; break;
+            case C_CV:      heldCV[e.index] = (int16_t)e.value; break;
+            case C_PULSE:   pulseIn[e.index] = e.value; clockPeriod[e.index] = 0; break;
+            case C_CLOCK:   clockPeriod[e.index] = (uint64_t)e.value; clockStart[e.index] = n; break;
+            case C_CONNECT: connected[e.index] = e.value; break;
+            case C_MIDI:    midiQueue.insert(midiQueue.end(), e.midi.begin(), e.midi.end()); break;
+            }
+        }
+
+        for (int i = 0; i < 2; i++) {
+            if (clockPeriod[i])
+                pulseIn[i] = (n - clockStart[i]) % clockPeriod[i] < clockPeriod[i] / 2;
+            const Track& a = audioTracks[i];
+            const Track& c = cvTracks[i];
+            audioIn[i] = a.present ? (n < a.samples.size() ? a.samples[n] : 0) : heldAudio[i];
+            cvIn[i]    = c.present ? (n < c.samples.size() ? c.samples[n] : 0) : heldCV[i];
+        }
+
+        if (multicore && n >= core0WakeAt) {
+            auto c0 = std::chrono::steady_clock::now();
+            turn = CORE0;
+            while (turn != AUDIO) std::this_thread::yield();
+            core0Ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::steady_clock::now() - c0).count();
+        }
+
+        ProcessSample();
+        simTime = n + 1;
+
+        if (opts.out)   { audioOutBuf.push_back(audioOut[0]); audioOutBuf.push_back(audioOut[1]); }
+        if (opts.cvOut) { cvOutBuf.push_back(cvOut[0]);       cvOutBuf.push_back(cvOut[1]); }
+        if (opts.csv && n % opts.csvEvery == 0) {
+            Snapshot s;
+            s.sample = n;
+            memcpy(s.audioOut, audioOut, sizeof(audioOut));
+            memcpy(s.cvOut, cvOut, sizeof(cvOut));
+            memcpy(s.pulseOut, pulseOut, sizeof(pulseOut));
+            memcpy(s.leds, leds, sizeof(leds));
+            rows.push_back(s);
+        }
+    }
+
+    // Time spent in core 0 is not the card's per-sample cost
+    double ns = (double)(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - t0).count() - core0Ns);
+
+    if (opts.out)   saveWav(opts.out, audioOutBuf);
+    if (opts.cvOut) saveWav(opts.cvOut, cvOutBuf);
+    if (opts.csv) {
+        FILE* f = fopen(opts.csv, "w");
+        if (!f) fail("cannot write %s", opts.csv);
+        fprintf(f, "sample,audio_out1,audio_out2,cv_out1,cv_out2,pulse_out1,pulse_out2,"
+                   "led0,led1,led2,led3,led4,led5\n");
+        for (const Snapshot& s : rows)
+            fprintf(f, "%llu,%d,%d,%d,%d,%d,%d,%u,%u,%u,%u,%u,%u\n",
+                    (unsigned long long)s.sample, s.audioOut[0], s.audioOut[1],
+                    s.cvOut[0], s.cvOut[1], s.pulseOut[0], s.pulseOut[1],
+                    s.leds[0], s.leds[1], s.leds[2], s.leds[3], s.leds[4], s.leds[5]);
+        fclose(f);
+    }
+    if (opts.flash) {
+        FILE* f = fopen(opts.flash, "wb");
+        if (!f) fail("cannot write %s", opts.flash);
+        fwrite(sim_flash, 1, sizeof(sim_flash), f);
+        fclose(f);
+    }
+
+    if (!opts.quiet) {
+        double seconds = (double)opts.samples / SAMPLE_RATE;
+        double perSample = opts.samples ? ns / (double)opts.samples : 0.0;
+        fprintf(stderr, "sim: %llu samples (%.2f s) in %.1f ms: %.1f ns/sample, %.0fx real time\n",
+                (unsigned long long)opts.samples, seconds, ns / 1e6, perSample,
+                ns > 0 ? seconds * 1e9 / ns : 0.0);
+    }
+    fflush(stdout);
+    fflush(stderr);
+
+    // A core 0 loop may still be spinning on the main thread
+    _Exit(0);
+}
+
+// ===========================================================
+// Entry point
+// ===========================================================
+
+int main(int argc, char** argv)
+{
+    double seconds = 0.0;
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        bool hasArg = i + 1 < argc;
+        if      (!strcmp(a, "--in1")     && hasArg) opts.audioIn[0] = argv[++i];
+        else if (!strcmp(a, "--in2")     && hasArg) opts.audioIn[1] = argv[++i];
+        else if (!strcmp(a, "--cv1")     && hasArg) opts.cvIn[0]    = argv[++i];
+        else if (!strcmp(a, "--cv2")     && hasArg) opts.cvIn[1]    = argv[++i];
+        else if (!strcmp(a, "--script")  && hasArg) opts.script     = argv[++i];
+        else if (!strcmp(a, "--out")     && hasArg) opts.out        = argv[++i];
+        else if (!strcmp(a, "--cv-out")  && hasArg) opts.cvOut      = argv[++i];
+        else if (!strcmp(a, "--csv")     && hasArg) opts.csv        = argv[++i];
+        else if (!strcmp(a, "--flash")   && hasArg) opts.flash      = argv[++i];
+        else if (!strcmp(a, "--seconds") && hasArg) seconds         = atof(argv[++i]);
+        else if (!strcmp(a, "--samples") && hasArg) opts.samples    = strtoull(argv[++i], nullptr, 0);
+        else if (!strcmp(a, "--csv-every") && hasArg) opts.csvEvery = (uint32_t)atoi(argv[++i]);
+        else if (!strcmp(a, "--quiet")) opts.quiet = true;
+        else usage();
+    }
+    if (opts.csvEvery == 0) opts.csvEvery = 1;
+
+    for (int i = 0; i < 2; i++) {
+        if (opts.audioIn[i]) loadWav(opts.audioIn[i], audioTracks[i]);
+        if (opts.cvIn[i])    loadWav(opts.cvIn[i], cvTracks[i]);
+    }
+    if (opts.script) loadScript(opts.script);
+
+    if (seconds > 0.0) opts.samples = (uint64_t)(seconds * SAMPLE_RATE + 0.5);
+    if (!opts.samples) {
+        opts.samples = SAMPLE_RATE;
+        for (int i = 0; i < 2; i++) {
+            if (audioTracks[i].samples.size() > opts.samples) opts.samples = audioTracks[i].samples.size();
+            if (cvTracks[i].samples.size() > opts.samples)    opts.samples = cvTracks[i].samples.size();
+        }
+        if (!events.empty() && events.back().time + 1 > opts.samples) opts.samples = events.back().time + 1;
+    }
+
+    // Erased flash, or a previously saved image
+    memset(sim_flash, 0xFF, sizeof(sim_flash));
+    if (opts.flash) {
+        if (FILE* f = fopen(opts.flash, "rb")) {
+            size_t n = fread(sim_flash, 1, sizeof(sim_flash), f);
+            (void)n;
+            fclose(f);
+        }
+    }
+
+    card_main();
+    return 0;
+}
@@ -0,0 +1,28 @@
+#ifndef SIM_TUSB_H
+#define SIM_TUSB_H
+
+// TinyUSB stand-in.  Only the MIDI device path carries data: bytes come from
+// `midi` events in the simulator script.  Host-mode calls are inert.
+
+#include "pico.h"
+
+#define TUD_OPT_RHPORT 0
+#define TUH_OPT_RHPORT 0
+#define TU_ATTR_WEAK   __attribute__((weak))
+
+typedef struct { uint8_t bLength; } tusb_desc_interface_t;
+typedef enum { XFER_RESULT_SUCCESS, XFER_RESULT_FAILED, XFER_RESULT_STALLED, XFER_RESULT_TIMEOUT } xfer_result_t;
+
+static inline bool tud_init(uint8_t) { return true; }
+static inline bool tuh_init(uint8_t) { return true; }
+// The USB task is where core 0 idles while waiting for MIDI
+static inline void tud_task() { sim_core0_idle(); }
+static inline void tuh_task() { sim_core0_idle(); }
+
+static inline uint32_t tud_midi_available() { return sim_midi_available(); }
+static inline uint32_t tud_midi_stream_read(void* buf, uint32_t bufsize)
+{
+    return sim_midi_read((uint8_t*)buf, bufsize);
+}
+
+#endif
@@ -3,6 +3,8 @@
 // A durable audio scratchpad stored in flash.  Record patchwork audio into
 // arbitrary positions, then loop-play any region.  Survives power cycles.
 // 16-bit lossless audio at 24 kHz (ISR runs at 48 kHz, every other sample).
+// Variant builds store µ-law or 4-bit ADPCM instead, and/or run at 48 kHz —
+// see SOZ_CODEC / SOZ_FULL_RATE below.
 //
 // SWITCH UP — Playback:
 //   Main knob = playback start offset within flash
@@ -21,18 +23,43 @@
 //
 // ERASE: hold switch down at power-on to wipe all recorded data.
 //
-// Buffer duration (2 bytes/sample at 24 kHz):
-//   2 MB flash  → ~38 s
-//  16 MB flash  → ~5.7 min
+// Buffer duration (2 MB flash; ×9 for 16 MB):
+//   16-bit  24 kHz (soz)        → ~38 s
+//   µ-law   24 kHz (soz_ulaw)   → ~76 s
+//   ADPCM   24 kHz (soz_adpcm)  → ~2.5 min
+//   µ-law   48 kHz (soz48)      → ~38 s
 //
 // LEDs: show position as a bar across the flash region.
 
 #include "ComputerCard.h"
+#include "ControlRate.h"
+#include "SampleCodec.h"
 #include "pico/multicore.h"
 #include "hardware/flash.h"
 #include "hardware/sync.h"
 #include <string.h>
 
+// ---- Storage format ----
+//
+// SOZ_CODEC      how samples are stored in flash: any codec from SampleCodec.h.
+//                Pcm16SampleCodec (default), MuLawSampleCodec or AdpcmSampleCodec.
+// SOZ_FULL_RATE  record and play every ISR tick (48 kHz) instead of every other.
+//
+// Flash written by one format plays back as noise in another; erase (hold the
+// switch down at power-on) after changing builds.  Erased flash reads as
+// silence in every format.
+
+#ifndef SOZ_CODEC
+#define SOZ_CODEC Pcm16SampleCodec
+#endif
+typedef SOZ_CODEC SampleCodec;
+
+#ifdef SOZ_FULL_RATE
+static constexpr bool FULL_RATE = true;
+#else
+static constexpr bool FULL_RATE = false;
+#endif
+
 // ---- Flash layout ----
 
 static constexpr uint32_t FLASH_CODE_RESERVE   = 256u * 1024u;
@@ -40,14 +67,13 @@ static constexpr uint32_t FLASH_REGION_SIZE    = PICO_FLASH_SIZE_BYTES - FLASH_C
 static constexpr uint32_t FLASH_REGION_SECTORS = FLASH_REGION_SIZE / FLASH_SECTOR_SIZE;
 static constexpr uint32_t FLASH_REGION_OFFSET  = FLASH_CODE_RESERVE;
 
-// 16-bit samples: 2048 samples per 4 KB sector
-static constexpr int SAMPLES_PER_SECTOR = FLASH_SECTOR_SIZE / 2;  // 2048
-static constexpr int BYTES_PER_SECTOR   = SAMPLES_PER_SECTOR * 2; // 4096
+// Each 4 KB sector is coded on its own: 2048 samples at 16 bits, 4096 µ-law,
+// 7936 ADPCM (31 blocks; the last 4 bytes are unused)
+static constexpr int SAMPLES_PER_SECTOR = SampleCodec::capacity(FLASH_SECTOR_SIZE);
 
 static constexpr uint32_t TOTAL_SAMPLES    = FLASH_REGION_SECTORS * (uint32_t)SAMPLES_PER_SECTOR;
-static constexpr uint32_t MIN_LOOP_SAMPLES = (uint32_t)SAMPLES_PER_SECTOR * 2;
 
-static constexpr int XFADE_LEN = 256;  // at 24 kHz, ~10 ms
+static constexpr int XFADE_LEN = FULL_RATE ? 512 : 256;  // ~10 ms
 
 // Double-buffered sector staging for recording.
 static uint8_t sectorBuf[2][FLASH_SECTOR_SIZE] __attribute__((aligned(4)));
@@ -70,15 +96,25 @@ static inline uint32_t wrapSample(uint32_t s)
     return s;
 }
 
-// Read a sample from flash given an absolute sample index (24 kHz domain).
-static inline int16_t readFlashSample(uint32_t sampleIdx)
+// A read position in flash.  The codec's Reader decodes within one sector,
+// so it is restarted whenever the head moves to another sector.
+struct PlayHead {
+    int                 sector = -1;
+    SampleCodec::Reader rd;
+};
+
+// Read a sample from flash given an absolute sample index (record-rate domain).
+static inline int16_t readFlashSample(PlayHead& head, uint32_t sampleIdx)
 {
     uint32_t sectorIdx   = sampleIdx / SAMPLES_PER_SECTOR;
-    uint32_t sampleInSec = sampleIdx % SAMPLES_PER_SECTOR;
-    uint32_t flashAddr   = FLASH_REGION_OFFSET + sectorIdx * FLASH_SECTOR_SIZE
-                         + sampleInSec * 2;
-    const int16_t* p     = (const int16_t*)(XIP_BASE + flashAddr);
-    return *p;
+    uint32_t sampleInSec = sampleIdx - sectorIdx * SAMPLES_PER_SECTOR;
+    if ((int)sectorIdx != head.sector) {
+        head.sector = (int)sectorIdx;
+        head.rd     = SampleCodec::Reader();
+    }
+    const uint8_t* sec = (const uint8_t*)(XIP_BASE + FLASH_REGION_OFFSET
+                                          + sectorIdx * FLASH_SECTOR_SIZE);
+    return head.rd.read(sec, (int)sampleInSec);
 }
 
 class Soz : public ComputerCard
@@ -88,7 +124,9 @@ public:
         : cursorSample(0), playPos(0), playOffset(0), playLoopLen(TOTAL_SAMPLES),
           targetOffset(0), targetLoopLen(TOTAL_SAMPLES),
           lastPlaySample(0), lastRecInput(0),
-          phase(0), wasDown(false), wasUp(false), knobUpdateCounter(0) {}
+          phase(0), wasDown(false), wasUp(false),
+          knobOffset(0), knobLoopLen(TOTAL_SAMPLES),
+          ledOffset(UINT32_MAX), ledLen(0), ledMask(0) {}
 
     static void audioEntry()
     {
@@ -127,6 +165,8 @@ public:
 
         while (true)
         {
+            tight_loop_contents();
+
             if (recPending) {
                 int sec = writeSectorIdx;
                 int sec1 = (sec + 1) % (int)FLASH_REGION_SECTORS;
@@ -175,12 +215,26 @@ public:
         int16_t input = AudioIn1();
         Switch sw = SwitchVal();
 
-        // ISR runs at 48 kHz; we process one 24 kHz sample every other call.
-        bool tick = (phase == 0);
+        // Knobs are read at 1 kHz, and the positions they select worked out
+        // only when one of them moves
+        bool knobsMoved = false;
+        if (control.tick()) {
+            knobsMoved  = knobMain.update(KnobVal(Knob::Main));
+            knobsMoved |= knobX.update(KnobVal(Knob::X));
+            knobY.update(KnobVal(Knob::Y));
+            if (knobsMoved) {
+                knobOffset  = knobToSampleOffset(knobMain.value());
+                knobLoopLen = knobToLoopLen(knobX.value());
+            }
+        }
+
+        // ISR runs at 48 kHz; we process one 24 kHz sample every other call
+        // (or every call, at full rate).
+        bool tick = FULL_RATE || (phase == 0);
         phase ^= 1;
 
         // =============================================================
-        // SWITCH DOWN — Record (sound-on-sound, 16-bit @ 24 kHz)
+        // SWITCH DOWN — Record (sound-on-sound)
         // =============================================================
         if (sw == Switch::Down) {
             if (!wasDown) {
@@ -190,29 +244,25 @@ public:
                 flushBank      = -1;
                 recording      = true;
                 recPending     = true;
-                recMix         = KnobVal(Knob::Y);
+                recMix         = knobY.value();
                 phase          = 0;
                 tick           = true;
                 wasDown = true;
             }
 
-            if (++knobUpdateCounter >= 1024) {
-                knobUpdateCounter = 0;
-                recMix = KnobVal(Knob::Y);
-            }
+            recMix = knobY.value();
 
             if (tick && !recPending) {
                 int mix = recMix;
-                int16_t* pre = (int16_t*)(preRead[writeBank]);
-                int16_t existing = pre[sectorSampleIdx];
+                if (sectorSampleIdx == 0) preReader = SampleCodec::Reader();
+                int16_t existing = preReader.read(preRead[writeBank], sectorSampleIdx);
 
                 int32_t mixed = ((int32_t)existing * (4095 - mix)
                                + (int32_t)input * mix) >> 12;
                 if (mixed >  2047) mixed =  2047;
                 if (mixed < -2048) mixed = -2048;
 
-                int16_t* dst = (int16_t*)(sectorBuf[writeBank]);
-                dst[sectorSampleIdx] = (int16_t)mixed;
+                encoder.write(sectorBuf[writeBank], sectorSampleIdx, (int16_t)mixed);
                 lastPlaySample = existing;
 
                 if (++sectorSampleIdx >= SAMPLES_PER_SECTOR) {
@@ -248,20 +298,22 @@ public:
         // =============================================================
         if (sw == Switch::Up) {
             if (!wasUp) {
-                playOffset  = knobToSampleOffset(KnobVal(Knob::Main));
-                playLoopLen = knobToLoopLen(KnobVal(Knob::X));
+                playOffset  = knobOffset;
+                playLoopLen = knobLoopLen;
                 targetOffset  = playOffset;
                 targetLoopLen = playLoopLen;
                 playPos = 0;
                 phase   = 0;
                 tick    = true;
                 wasUp = true;
+                // Flash may have been rewritten since these last read it
+                playHead = PlayHead();
+                xfadeHead = PlayHead();
             }
 
-            if (++knobUpdateCounter >= 1024) {
-                knobUpdateCounter = 0;
-                targetOffset  = knobToSampleOffset(KnobVal(Knob::Main));
-                targetLoopLen = knobToLoopLen(KnobVal(Knob::X));
+            if (knobsMoved) {
+                targetOffset  = knobOffset;
+                targetLoopLen = knobLoopLen;
 
                 // If playhead is beyond the new loop length, restart
                 if (playPos >= targetLoopLen) {
@@ -282,13 +334,13 @@ public:
                 }
 
                 uint32_t absSample = wrapSample(playOffset + pos);
-                int16_t smp = readFlashSample(absSample);
+                int16_t smp = readFlashSample(playHead, absSample);
 
                 // Crossfade at loop boundary
                 if (playLoopLen > (uint32_t)(XFADE_LEN * 2) && pos >= playLoopLen - XFADE_LEN) {
                     uint32_t xOff = pos - (playLoopLen - XFADE_LEN);
                     uint32_t headSample = wrapSample(playOffset + xOff);
-                    int16_t smp2 = readFlashSample(headSample);
+                    int16_t smp2 = readFlashSample(xfadeHead, headSample);
                     int fade = (int)(xOff * 256 / XFADE_LEN);
                     smp = (int16_t)(smp + (((smp2 - smp) * fade) >> 8));
                 }
@@ -307,37 +359,59 @@ public:
         // SWITCH MIDDLE — Stopped, position cursor
         // =============================================================
         wasUp = false;
-        cursorSample  = knobToSampleOffset(KnobVal(Knob::Main));
-        targetLoopLen = knobToLoopLen(KnobVal(Knob::X));
+        cursorSample  = knobOffset;
+        targetLoopLen = knobLoopLen;
         playLoopLen   = targetLoopLen;
 
         AudioOut1(0);
         AudioOut2(input);
 
-        int ledIdx = (int)((uint64_t)cursorSample * 6 / TOTAL_SAMPLES);
-        if (ledIdx > 5) ledIdx = 5;
-        for (int i = 0; i < 6; i++) LedOn(i, i == ledIdx);
+        showCursorLED(cursorSample);
     }
 
 private:
+    // Both snap to whole sectors.  Worked in sectors rather than samples so
+    // that knob × range stays within 32 bits for large flash and the denser
+    // codecs.
     uint32_t knobToSampleOffset(int knob)
     {
-        uint32_t sample = ((uint32_t)knob * (TOTAL_SAMPLES - SAMPLES_PER_SECTOR)) >> 12;
-        sample = (sample / SAMPLES_PER_SECTOR) * SAMPLES_PER_SECTOR;
-        return sample;
+        uint32_t sector = ((uint32_t)knob * (FLASH_REGION_SECTORS - 1u)) >> 12;
+        return sector * SAMPLES_PER_SECTOR;
     }
 
     uint32_t knobToLoopLen(int knob)
     {
-        uint32_t len = MIN_LOOP_SAMPLES
-                     + ((uint32_t)knob * (TOTAL_SAMPLES - MIN_LOOP_SAMPLES)) / 4096u;
-        len = (len / SAMPLES_PER_SECTOR) * SAMPLES_PER_SECTOR;
-        if (len < MIN_LOOP_SAMPLES) len = MIN_LOOP_SAMPLES;
-        return len;
+        uint32_t sectors = 2u + (((uint32_t)knob * (FLASH_REGION_SECTORS - 2u)) >> 12);
+        return sectors * SAMPLES_PER_SECTOR;
     }
 
+    // The LED patterns take 64-bit divides, so they are worked out only when
+    // what they show changes; ledLen == 0 marks a cursor pattern.
     void showRegionLEDs(uint32_t offset, uint32_t len)
     {
+        if (offset != ledOffset || len != ledLen) {
+            ledOffset = offset;
+            ledLen    = len;
+            ledMask   = regionLEDMask(offset, len);
+        }
+        for (int i = 0; i < 6; i++) LedOn(i, (ledMask >> i) & 1);
+    }
+
+    void showCursorLED(uint32_t cursor)
+    {
+        if (cursor != ledOffset || ledLen != 0) {
+            ledOffset = cursor;
+            ledLen    = 0;
+            int ledIdx = (int)((uint64_t)cursor * 6 / TOTAL_SAMPLES);
+            if (ledIdx > 5) ledIdx = 5;
+            ledMask = (uint8_t)(1u << ledIdx);
+        }
+        for (int i = 0; i < 6; i++) LedOn(i, (ledMask >> i) & 1);
+    }
+
+    static uint8_t regionLEDMask(uint32_t offset, uint32_t len)
+    {
+        uint8_t mask = 0;
         for (int i = 0; i < 6; i++) {
             uint32_t ledStart = (uint32_t)((uint64_t)i * TOTAL_SAMPLES / 6);
             uint32_t ledEnd   = (uint32_t)((uint64_t)(i + 1) * TOTAL_SAMPLES / 6);
@@ -348,8 +422,9 @@ private:
             } else {
                 lit = (ledEnd > offset) || (ledStart < (loopEnd % TOTAL_SAMPLES));
             }
-            LedOn(i, lit);
+            if (lit) mask |= (uint8_t)(1u << i);
         }
+        return mask;
     }
 
     uint32_t cursorSample;
@@ -361,9 +436,19 @@ private:
     int16_t  lastPlaySample;  // held for sample-and-hold on odd ISR calls
     int16_t  lastRecInput;
     int      phase;           // 0 or 1, toggles each ISR call for 24 kHz decimation
+    PlayHead playHead;        // playback position
+    PlayHead xfadeHead;       // loop-start read during the crossfade
+    SampleCodec::Reader  preReader;  // existing audio in preRead[writeBank]
+    SampleCodec::Encoder encoder;    // into sectorBuf[writeBank]
     bool     wasDown;
     bool     wasUp;
-    int      knobUpdateCounter;
+    ControlClock<48> control;
+    ControlValue     knobMain, knobX, knobY;
+    uint32_t knobOffset;      // knobToSampleOffset(Main knob)
+    uint32_t knobLoopLen;     // knobToLoopLen(X knob)
+    uint32_t ledOffset;       // what the LEDs currently show
+    uint32_t ledLen;
+    uint8_t  ledMask;
 
 public:
     static Soz* s_instance;
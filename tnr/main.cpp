@@ -1,10 +1,26 @@
 #include "ComputerCard.h"
+#include "pico/multicore.h"
 #include "../Tuner.h"
+#include "../VOctCalibration.h"
 
 class Tnr : public ComputerCard {
-    PitchDetector pd1, pd2;
+    // Calibration timing: settle after each CV step, then READINGS pitch
+    // readings READING_MS apart, which must agree to within SPREAD
+    static const uint32_t SETTLE_MS  = 400;
+    static const uint32_t READING_MS = 50;
+    static const int      READINGS   = 8;
+    static const int32_t  SPREAD     = 273;    // 5 cents in Q16 octaves
+    static const uint8_t  MEASURING  = 0xFF;   // calResult while the sweep runs
+
+    YinPitchDetector pd1, pd2;
     uint8_t counter;
 
+    // Calibration mode, driven from core 1
+    volatile bool    calibrating;
+    volatile int16_t calCV;       // both CV outputs during the sweep
+    volatile uint8_t calResult;   // MEASURING, then bit i set if output i calibrated
+    uint16_t blink;
+
     // ledFlat=4, ledCenter=2, ledSharp=0  (0 = above C, 4 = below C)
     void applyLeds(TunerLedValues v, uint8_t ledFlat, uint8_t ledCenter, uint8_t ledSharp) {
         LedBrightness(ledFlat,   v.flat);
@@ -12,27 +28,136 @@ class Tnr : public ComputerCard {
         LedBrightness(ledSharp,  v.sharp);
     }
 
+    // All LEDs blink during the sweep; then, per channel, the centre LED for
+    // an output calibrated or the flat LED for one that failed
+    void showCalibration() {
+        uint8_t r = calResult;
+        if (r == MEASURING) {
+            bool on = (++blink >> 6) & 1;
+            for (int i = 0; i < 6; i++) LedOn(i, on);
+            return;
+        }
+        for (int ch = 0; ch < 2; ch++) {
+            bool ok = r & (1 << ch);
+            LedOff(ch);
+            LedOn(2 + ch, ok);
+            LedOn(4 + ch, !ok);
+        }
+    }
+
+    // Keep both detectors analysing for ms milliseconds.  update() does a
+    // slice of a search per call, so run each search to the end before
+    // sleeping.
+    void analyse(uint32_t ms) {
+        for (uint32_t t = 0; t < ms; t++) {
+            do {
+                pd1.update();
+                pd2.update();
+            } while (pd1.searching() || pd2.searching());
+            sleep_ms(1);
+        }
+    }
+
+    // Pitch of each channel at anchor k, as -log2(period) in Q16, or MISSING
+    // if either channel lost the pitch or wandered during the readings
+    void measure(VOctCalibration::Record& rec, int k) {
+        YinPitchDetector* pd[2] = { &pd1, &pd2 };
+        int32_t sum[2] = { 0, 0 }, lo[2] = { INT32_MAX, INT32_MAX }, hi[2] = { INT32_MIN, INT32_MIN };
+        bool ok[2] = { true, true };
+        for (int r = 0; r < READINGS; r++) {
+            analyse(READING_MS);
+            for (int ch = 0; ch < 2; ch++) {
+                uint32_t p = pd[ch]->periodQ8();
+                if (!p) { ok[ch] = false; continue; }
+                int32_t l = log2Q16(p);
+                sum[ch] += l;
+                if (l < lo[ch]) lo[ch] = l;
+                if (l > hi[ch]) hi[ch] = l;
+            }
+        }
+        for (int ch = 0; ch < 2; ch++)
+            rec.pitch[ch][k] = (ok[ch] && hi[ch] - lo[ch] <= SPREAD) ? -(sum[ch] / READINGS)
+                                                                    : VOctCalibration::MISSING;
+    }
+
+    // Step both outputs through the anchors, measure, fit and save.  Outputs
+    // whose input heard no steady pitch are saved uncalibrated, so a sweep
+    // with nothing patched clears the calibration.
+    void calibrate() {
+        VOctCalibration::Record rec;
+        calResult   = MEASURING;
+        calibrating = true;
+        for (int k = 0; k < VOctCalibration::ANCHORS; k++) {
+            calCV = VOctCalibration::anchorCV(k);
+            analyse(SETTLE_MS);
+            measure(rec, k);
+        }
+
+        VOctCalibration fit;
+        uint8_t ok = fit.build(rec);
+        multicore_lockout_start_blocking();
+        VOctCalibration::save(rec);
+        multicore_lockout_end_blocking();
+
+        // Show the result for three seconds, then back to the tuner
+        calResult = ok;
+        analyse(3000);
+        calibrating = false;
+    }
+
 public:
-    Tnr() : counter(0) {}
+    Tnr() : counter(0), calibrating(false), calCV(0), calResult(0), blink(0) {}
+
+    static Tnr* s_instance;   // set by main() before multicore_launch_core1
+
+    // Core 1: the pitch searches, off the audio core.  Holding the switch
+    // down at power-up runs the CV output calibration first.
+    static void analysisEntry()
+    {
+        s_instance->analyse(150);   // let the switch reading settle
+        if (s_instance->SwitchVal() == Switch::Down)
+            s_instance->calibrate();
+
+        while (true) {
+            s_instance->pd1.update();
+            s_instance->pd2.update();
+            tight_loop_contents();
+        }
+    }
 
     virtual void ProcessSample() override {
-        // Both CV outputs emit middle C
-        CVOutMIDINote(0, 60);
-        CVOutMIDINote(1, 60);
+        if (calibrating) {
+            CVOut(0, calCV);
+            CVOut(1, calCV);
+        } else {
+            // Both CV outputs emit middle C
+            CVOutMIDINote(0, 60);
+            CVOutMIDINote(1, 60);
+        }
 
         pd1.addSample(AudioIn1());
         pd2.addSample(AudioIn2());
 
         // Update display at ~187 Hz (every 256 samples)
         if (!counter) {
-            applyLeds(tunerLedValues(periodToCloseness(pd1.period())), 4, 2, 0);
-            applyLeds(tunerLedValues(periodToCloseness(pd2.period())), 5, 3, 1);
+            if (calibrating) {
+                showCalibration();
+            } else {
+                applyLeds(tunerLedValues(periodQ8ToCloseness(pd1.periodQ8())), 4, 2, 0);
+                applyLeds(tunerLedValues(periodQ8ToCloseness(pd2.periodQ8())), 5, 3, 1);
+            }
         }
         counter++;
     }
 };
 
+Tnr* Tnr::s_instance = nullptr;
+
 int main() {
-    Tnr tnr;
+    static Tnr tnr;
+    Tnr::s_instance = &tnr;
+    // Audio on core 0 (lockout victim, so core 1 can save the calibration)
+    multicore_lockout_victim_init();
+    multicore_launch_core1(Tnr::analysisEntry);
     tnr.Run();
 }
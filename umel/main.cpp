@@ -1,11 +1,12 @@
 #include "ComputerCard.h"
+#include "VOctCalibration.h"
 
 class Delay8
 {
 
 };
 ///
-class UMel : public ComputerCard
+class UMel : public VOctCard<ComputerCard>
 {
     private:
 
@@ -136,8 +137,8 @@ class UMel : public ComputerCard
 
                 if(n)
                 {
-                    CVOutMIDINote(0, n);
-                    CVOutMIDINote(1, n);
+                    CVOutNote(0, n);
+                    CVOutNote(1, n);
                 }
 
                 LedOn(0, n > 0);
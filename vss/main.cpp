@@ -4,6 +4,8 @@
 // RECORD  (hold Z switch DOWN):
 //   Samples Audio In 1 into an 8-bit mono buffer (~6 sec at 24 kHz).
 //   Stops when the buffer is full or the switch is released.
+//   Built with VSS_ADPCM (the vss_adpcm target) samples are stored as
+//   4-bit IMA ADPCM instead, for ~11.6 sec in the same RAM and flash.
 //
 // PLAY  (USB MIDI, 6-voice polyphonic):
 //   Connect a USB MIDI keyboard or controller (device mode).
@@ -22,6 +24,7 @@
 // Y KNOB:  Delay time (Audio Out 2 only).
 //   Left  (CCW) = ~50 ms (slapback)
 //   Right (CW)  = ~750 ms (long echo, ~5 repeats, darkening)
+//                 ~1.5 s built with VSS_LONG_ECHO
 //
 // OUTPUTS:
 //   Audio Out 1 = dry mix
@@ -31,9 +34,11 @@
 //   0-5  = voice activity / bank indicator
 
 #include "ComputerCard.h"
-#include "MuLawCodec.h"
+#include "SampleCodec.h"
 #include "../Tuner.h"
+#include "../VOctCalibration.h"
 #include "Delay.h"
+#include "ControlRate.h"
 #include "pico/multicore.h"
 #include "hardware/flash.h"
 #include "hardware/sync.h"
@@ -43,8 +48,21 @@
 #include <string.h>
 
 
-static MuLawCodec codec;
-static Delay delay;
+#ifdef VSS_ADPCM
+typedef AdpcmSampleCodec SampleCodec;
+#else
+typedef MuLawSampleCodec SampleCodec;
+#endif
+
+// Echo on Audio Out 2: 750 ms in 72 KB, or with VSS_LONG_ECHO (the
+// vss_long_echo target) 1.5 s in the same RAM, stored as µ-law
+#ifdef VSS_LONG_ECHO
+typedef Delay<72000, MuLawDelayStorage> EchoDelay;
+#else
+typedef Delay<> EchoDelay;
+#endif
+
+static EchoDelay delay;
 
 // ===========================================================
 // ADSR PRESETS  –  Edit these freely to taste!
@@ -83,7 +101,8 @@ static const uint32_t SAMPLE_RATE = 48000;
 // Record at half the output rate (24 kHz) for a longer buffer.
 // Playback step is halved accordingly so pitch stays correct.
 static const int      RECORD_RATE = SAMPLE_RATE / 2;          // 24 kHz
-static const int      BUFFER_SIZE = RECORD_RATE * 6;          // 144 000 bytes ≈ 141 KB, 6 s
+static const int      BUFFER_BYTES = RECORD_RATE * 6;         // 144 000 bytes ≈ 141 KB
+static const int      BUFFER_SIZE  = SampleCodec::capacity(BUFFER_BYTES);  // samples: 6 s µ-law, 11.6 s ADPCM
 
 // Loop crossfade length in samples (~170 ms at base pitch).
 // When pos enters the last XFADE_LEN samples before the loop end, we
@@ -97,7 +116,7 @@ static_assert((XFADE_LEN & (XFADE_LEN - 1)) == 0, "XFADE_LEN must be a power of
 // Flash storage layout (end of 2 MB flash), 6 banks stacked from the end:
 //   each bank = 36 data sectors + 1 meta sector = 37 sectors = 148 KB
 //   bank 0 is closest to end of flash (same location as the original single-bank layout)
-static const uint32_t FLASH_DATA_SECTORS = ((uint32_t)BUFFER_SIZE + FLASH_SECTOR_SIZE - 1u) / FLASH_SECTOR_SIZE;  // 36
+static const uint32_t FLASH_DATA_SECTORS = ((uint32_t)BUFFER_BYTES + FLASH_SECTOR_SIZE - 1u) / FLASH_SECTOR_SIZE;  // 36
 static const uint32_t FLASH_BANK_SECTORS = FLASH_DATA_SECTORS + 1u;   // 37 per bank
 static const int      FLASH_NUM_BANKS    = 6;
 static const uint32_t FLASH_MAGIC        = 0x56535302u;  // 'V','S','S', version 2 (+ XOR field)
@@ -109,6 +128,8 @@ static uint32_t flashDataOffset(int bank) {
 static uint32_t flashMetaOffset(int bank) {
     return flashDataOffset(bank) + FLASH_DATA_SECTORS * FLASH_SECTOR_SIZE;
 }
+// Meta sector: [0-3] magic  [4-7] len (samples)  [8-11] loop start  [12] data XOR
+//              [13] SampleCodec::TAG (0 = µ-law; banks saved before the tag existed read 0)
 // Config sector: one sector immediately before (lower address than) all sample banks.
 // Format: [0-3] magic  [4] midiChannel (0=omni,1-16)  [5-255] reserved (0xFF)
 static uint32_t flashConfigOffset() {
@@ -116,7 +137,7 @@ static uint32_t flashConfigOffset() {
            - (uint32_t)(FLASH_NUM_BANKS * FLASH_BANK_SECTORS + 1u) * FLASH_SECTOR_SIZE;
 }
 
-static uint8_t sampleBuffer[BUFFER_SIZE] __attribute__((aligned(4)));
+static uint8_t sampleBuffer[BUFFER_BYTES] __attribute__((aligned(4)));
 static volatile int  sampleLen  = 0;
 
 static const int BASE_NOTE = 60;   // MIDI C4 = 1 : 1 playback speed
@@ -238,17 +259,17 @@ struct MIDIMsg {
 // ===========================================================
 // VSS card
 // ===========================================================
-class VSS : public ComputerCard
+class VSS : public VOctCard<ComputerCard>
 {
 public:
     VSS() : flashPending(false), bankIdx(0), pendingBank(0),
             recording(false), prevSwitchDown(true), prevSwitchUp(false),
             savedToFlash(false), isUSBMIDIHost(false),
             writeHead(0), recordDecimate(0), presetIdx(0), presetFlashTimer(0),
-            loopStartPt(0), pendingDelayCapture(false), delayKnobY(0),
+            loopStartPt(0), pendingDelayCapture(false), delayKnobY(0), delayBuf(), delayBufPos(0),
             pendingCVNoteOn(false), pendingCVNote(0), gateState(false), cvGateNote(0),
             bendMult(65536u), modWheel(0), lfoInc(0), vibratoRate(64),
-            arpIdx(-1), arpGateTimer(0), arpIntTimer(0),
+            arpIdx(-1), arpGateTimer(0), arpIntTimer(0), arpPeriod(EchoDelay::samplesForKnob(0)),
             midiClockTick(false), hasMidiClock(false), midiClockCount(0),
             midiChannel(0), inConfigMode(false), configMidiChan(0), configVibRate(64),
             tunerCounter(0)
@@ -267,18 +288,21 @@ public:
 
         uint32_t magic; memcpy(&magic, meta, 4);
         if (magic != FLASH_MAGIC) return;
+        if (meta[13] != SampleCodec::TAG) return;   // recorded by a build with another codec
 
         int32_t len, lsp;
         memcpy(&len, meta + 4, 4);
         memcpy(&lsp, meta + 8, 4);
         if (len <= 0 || len > BUFFER_SIZE) return;
 
-        memcpy(sampleBuffer, (const uint8_t*)(XIP_BASE + flashDataOffset(bank)), (size_t)len);
+        int32_t bytes = SampleCodec::bytesFor(len);
+        memcpy(sampleBuffer, (const uint8_t*)(XIP_BASE + flashDataOffset(bank)), (size_t)bytes);
+        resetReaders();   // buffer contents changed under them
 
         uint8_t storedXor = 0;
         memcpy(&storedXor, meta + 12, 1);
         uint8_t computedXor = 0;
-        for (int32_t i = 0; i < len; i++) computedXor ^= sampleBuffer[i];
+        for (int32_t i = 0; i < bytes; i++) computedXor ^= sampleBuffer[i];
         if (computedXor != storedXor) return;   // data corrupted
 
         sampleLen    = len;
@@ -376,19 +400,21 @@ public:
         // Prepare pages before disabling interrupts (memcpy/memset are safe here).
         static uint8_t metaPage[FLASH_PAGE_SIZE] __attribute__((aligned(4)));
         memset(metaPage, 0, FLASH_PAGE_SIZE);
+        int      bytes = SampleCodec::bytesFor(len);
         uint32_t magic = FLASH_MAGIC;
         int32_t  iLen  = (int32_t)len;
         int32_t  iLsp  = (int32_t)loopStartPt;
         uint8_t  xorChk = 0;
-        for (int i = 0; i < len; i++) xorChk ^= sampleBuffer[i];
+        for (int i = 0; i < bytes; i++) xorChk ^= sampleBuffer[i];
         memcpy(metaPage,      &magic,  4);
         memcpy(metaPage + 4,  &iLen,   4);
         memcpy(metaPage + 8,  &iLsp,   4);
         memcpy(metaPage + 12, &xorChk, 1);
+        metaPage[13] = SampleCodec::TAG;
 
         static uint8_t lastPage[FLASH_PAGE_SIZE] __attribute__((aligned(4)));
-        uint32_t fullBytes = ((uint32_t)len / FLASH_PAGE_SIZE) * FLASH_PAGE_SIZE;
-        uint32_t remaining = (uint32_t)len - fullBytes;
+        uint32_t fullBytes = ((uint32_t)bytes / FLASH_PAGE_SIZE) * FLASH_PAGE_SIZE;
+        uint32_t remaining = (uint32_t)bytes - fullBytes;
         if (remaining > 0) {
             memset(lastPage, 0, FLASH_PAGE_SIZE);
             memcpy(lastPage, sampleBuffer + fullBytes, remaining);
@@ -421,7 +447,7 @@ public:
         // Verify magic
         uint32_t flash_magic_r = 0;
         memcpy(&flash_magic_r, fmeta, 4);
-        bool magicOk = (flash_magic_r == FLASH_MAGIC);
+        bool magicOk = (flash_magic_r == FLASH_MAGIC) && fmeta[13] == SampleCodec::TAG;
 
         // Verify len stored in meta
         int32_t flash_len_r = 0;
@@ -436,7 +462,7 @@ public:
         // Full-buffer XOR checksum: catches any data corruption, no false positives
         // from silence (0xFF matches erased flash) unlike spot checks.
         uint8_t sram_xor = 0, flash_xor = 0;
-        for (int i = 0; i < len; i++) {
+        for (int i = 0; i < bytes; i++) {
             sram_xor  ^= sampleBuffer[i];
             flash_xor ^= fdata[i];
         }
@@ -513,6 +539,11 @@ public:
             if (flashPending)
                 saveToFlash();
 
+            // Tuner pitch search, a slice per pass (at most LAGS_PER_UPDATE
+            // lags, ~0.3 ms) so USB is not held up; returns at once unless a
+            // search is under way or core 1 has fed it a new hop of samples
+            tunerPd.update();
+
             if (isUSBMIDIHost) {
                 tuh_task();
                 // MIDI data arrives via tuh_midi_rx_cb callback below
@@ -715,10 +746,29 @@ public:
 
     }
 
+    // Forget every play head's position, after the buffer has been rewritten.
+    void resetReaders()
+    {
+        for (int i = 0; i < MAX_VOICES; i++) {
+            voiceReader[i] = SampleCodec::Reader();
+            xfadeReader[i] = SampleCodec::Reader();
+        }
+        loopEntry = SampleCodec::Reader();
+    }
+
+    // Set the loop start and park loopEntry on it, so a voice wrapping round
+    // the loop (or starting its crossfade) never has to seek for it.
+    void setLoopStart(int ls)
+    {
+        loopStartPt = ls;
+        loopEntry   = SampleCodec::Reader();
+        if (ls < sampleLen) loopEntry.read(sampleBuffer, ls);
+    }
+
     // Find the loop start point that gives the smoothest crossfade.
     //
-    // The crossfade blends sampleBuffer[len-XFADE_LEN..len-1] (tail) into
-    // sampleBuffer[loopStart..loopStart+XFADE_LEN-1] (head).  We search
+    // The crossfade blends samples [len-XFADE_LEN..len-1] (tail) into
+    // [loopStart..loopStart+XFADE_LEN-1] (head).  We search
     // candidates near the 2/3 mark and pick the one where the head region
     // best matches the tail region (lowest sum-of-squared-differences).
     //
@@ -727,7 +777,7 @@ public:
     void computeLoopStart()
     {
         int len = sampleLen;
-        if (len < XFADE_LEN * 3) { loopStartPt = (len * 2) / 3; return; }
+        if (len < XFADE_LEN * 3) { setLoopStart((len * 2) / 3); return; }
 
         int nominal = (len * 2) / 3;
         int searchRadius = XFADE_LEN;
@@ -739,23 +789,37 @@ public:
         static const int COMPARE_STEP = 8;
         static const int COMPARE_LEN  = XFADE_LEN / COMPARE_STEP;  // 512 comparisons
         int16_t tail[COMPARE_LEN];
+        SampleCodec::Reader rd;
         for (int j = 0; j < COMPARE_LEN; j++)
-            tail[j] = codec.decodeSample(sampleBuffer[len - XFADE_LEN + j * COMPARE_STEP]);
+            tail[j] = rd.read(sampleBuffer, len - XFADE_LEN + j * COMPARE_STEP);
 
         int best = nominal;
         uint32_t bestErr = UINT32_MAX;
 
-        for (int cand = lo; cand < hi; cand++) {
-            uint32_t err = 0;
-            for (int j = 0; j < COMPARE_LEN; j++) {
-                int16_t head = codec.decodeSample(sampleBuffer[cand + j * COMPARE_STEP]);
-                int diff = head - tail[j];
-                err += (uint32_t)(diff * diff);
-                if (err >= bestErr) break;   // early out
+        // Candidates are taken one residue (cand mod COMPARE_STEP) at a time:
+        // all candidates of a residue compare against the same every-8th
+        // sample sequence, which is decoded once, reading forward, into head[].
+        // Ties go to the lowest candidate, as in a plain ascending scan.
+        static int16_t head[(2 * XFADE_LEN + XFADE_LEN) / COMPARE_STEP];
+        for (int r = 0; r < COMPARE_STEP && lo + r < hi; r++) {
+            int first = lo + r;
+            int nCand = (hi - first + COMPARE_STEP - 1) / COMPARE_STEP;
+            rd = SampleCodec::Reader();
+            for (int k = 0; k < nCand + COMPARE_LEN - 1; k++)
+                head[k] = rd.read(sampleBuffer, first + k * COMPARE_STEP);
+
+            for (int c = 0; c < nCand; c++) {
+                int cand = first + c * COMPARE_STEP;
+                uint32_t err = 0;
+                for (int j = 0; j < COMPARE_LEN; j++) {
+                    int diff = head[c + j] - tail[j];
+                    err += (uint32_t)(diff * diff);
+                    if (err > bestErr) break;   // early out
+                }
+                if (err < bestErr || (err == bestErr && cand < best)) { bestErr = err; best = cand; }
             }
-            if (err < bestErr) { bestErr = err; best = cand; }
         }
-        loopStartPt = best;
+        setLoopStart(best);
     }
 
     // ---- Audio core (core 0) ----------------------------------------
@@ -781,13 +845,14 @@ public:
                 writeHead    = 0;
                 sampleLen    = 0;
                 loopStartPt  = 0;
+                resetReaders();
                 savedToFlash = false;   // new recording invalidates any previous save
                 recording    = true;
             }
             if (writeHead < BUFFER_SIZE) {
                 // Decimate to 24 kHz: write one sample every two output ticks
                 if (recordDecimate == 0)
-                    sampleBuffer[writeHead++] = codec.encodeSample(AudioIn1());
+                    encoder.write(sampleBuffer, writeHead++, AudioIn1());
                 recordDecimate ^= 1;
             } else if (recording) {
                 // Buffer full: finish recording (guard prevents re-entry each tick)
@@ -808,21 +873,24 @@ public:
         bool switchUp    = (sw == Switch::Up);
         bool switchJustUp = switchUp && !prevSwitchUp;
         prevSwitchUp = switchUp;
-        // --- Preset selection (Main knob) and bank selection (X knob) ---
-        {
-            int newPreset = (KnobVal(Knob::Main) * NUM_PRESETS) >> 12;
-            if (newPreset >= NUM_PRESETS) newPreset = NUM_PRESETS - 1;
-            if (newPreset != presetIdx) {
-                presetIdx       = newPreset;
-                presetFlashTimer = PRESET_FLASH_LEN;
-            }
-        }
-        {
-            int newBank = (KnobVal(Knob::X) * FLASH_NUM_BANKS) >> 12;
-            if (newBank >= FLASH_NUM_BANKS) newBank = FLASH_NUM_BANKS - 1;
-            if (newBank != bankIdx) {
+        // --- Knobs, at 1 kHz: preset (Main), bank (X), delay and arp time (Y) ---
+        if (control.tick()) {
+            knobMain.update(KnobVal(Knob::Main), [this](int v) {
+                int newPreset = (v * NUM_PRESETS) >> 12;
+                if (newPreset >= NUM_PRESETS) newPreset = NUM_PRESETS - 1;
+                if (newPreset != presetIdx) {
+                    presetIdx       = newPreset;
+                    presetFlashTimer = PRESET_FLASH_LEN;
+                }
+            });
+            knobX.update(KnobVal(Knob::X), [this](int v) {
+                int newBank = (v * FLASH_NUM_BANKS) >> 12;
+                if (newBank >= FLASH_NUM_BANKS) newBank = FLASH_NUM_BANKS - 1;
                 bankIdx = newBank;
-            }
+            });
+            knobY.update(KnobVal(Knob::Y), [this](int v) {
+                arpPeriod = EchoDelay::samplesForKnob(v);
+            });
         }
 
         // --- Save to flash ---
@@ -853,6 +921,8 @@ public:
 
             for (int i = 0; i < MAX_VOICES; i++) {
                 if (!voices[i].active) continue;
+                SampleCodec::Reader& rd = voiceReader[i];
+                SampleCodec::Reader& xr = xfadeReader[i];
 
                 // Snapshot volatile fields into registers
                 uint32_t vGen       = voices[i].gen;
@@ -886,9 +956,12 @@ public:
                         pos = wrapTarget;
                     }
                     vPhase = (uint32_t)pos << 8;
+                    // Carry on from the crossfade head, which has just read up to
+                    // wrapTarget, or from the loop start
+                    rd = canXfade ? xr : loopEntry;
                 }
 
-                // 8-bit unsigned → 12-bit signed sample, with runtime loop crossfade.
+                // Stored sample → 12-bit signed sample, with runtime loop crossfade.
                 int16_t smp;
                 if (canXfade && pos >= xfZoneStart) {
                     int xOff = pos - xfZoneStart;           // 0 .. XFADE_LEN-1
@@ -897,11 +970,13 @@ public:
                     int t2   = (t * t) >> 8;                // t² normalised to 0..255
                     int t3   = (t2 * t) >> 8;               // t³ normalised to 0..255
                     int ts   = 3 * t2 - 2 * t3;            // smoothstep, 0..256
-                    int s1   = codec.decodeSample(sampleBuffer[pos]);
-                    int s2   = codec.decodeSample(sampleBuffer[loopStart + xOff]);
+                    int hp   = loopStart + xOff;
+                    if (xr.needsSeek(hp)) xr = loopEntry;
+                    int s1   = rd.read(sampleBuffer, pos);
+                    int s2   = xr.read(sampleBuffer, hp);
                     smp = (int16_t)(s1 + (((s2 - s1) * ts) >> 8));
                 } else {
-                    smp = codec.decodeSample(sampleBuffer[pos]);
+                    smp = rd.read(sampleBuffer, pos);
                 }
 
                 // ADSR envelope update
@@ -981,11 +1056,11 @@ public:
         //   but only when the gate is currently low. Holds the gate high until that
         //   specific note's voice finishes completely, then waits for the next trigger.
         if (tunerMode) {
-            CVOut1MIDINote(60);
+            CVOutNote(0, 60);
         } else if (pendingCVNoteOn) {
             if (!gateState) {
                 cvGateNote = pendingCVNote;
-                CVOut1MIDINote(cvGateNote > 11 ? cvGateNote - 12 : cvGateNote);
+                CVOutNote(0, cvGateNote > 11 ? cvGateNote - 12 : cvGateNote);
                 PulseOut1(true);
                 gateState = true;
             }
@@ -996,10 +1071,18 @@ public:
 
         // Audio Out 2: delay wet only (unchanged by tuner mode).
         if (pendingDelayCapture) {
-            delayKnobY          = KnobVal(Knob::Y);
+            delayKnobY          = knobY.value();
             pendingDelayCapture = false;
         }
-        AudioOut2(delay.process((int16_t)mix, delayKnobY));
+        // The delay runs DELAY_BLOCK samples at a time, in place in delayBuf:
+        // each tick plays the wet sample computed last block and stores the
+        // dry one in its slot.  Adds DELAY_BLOCK samples (0.33 ms) to the echo.
+        AudioOut2(delayBuf[delayBufPos]);
+        delayBuf[delayBufPos] = (int16_t)mix;
+        if (++delayBufPos == DELAY_BLOCK) {
+            delayBufPos = 0;
+            delay.processBlock(delayBuf, delayBuf, DELAY_BLOCK, delayKnobY);
+        }
 
         // --- Arpeggiator (CV Out 2 / Gate Out 2) ---
         // Count held notes (active, non-releasing); defer sorting to tick time
@@ -1031,8 +1114,7 @@ public:
             }
             arpIntTimer = 0;
         } else if (!hasMidiClock) {
-            int period = 2400 + (int)(((uint32_t)KnobVal(Knob::Y) * 33600u) >> 12);
-            if (++arpIntTimer >= period) { arpIntTimer = 0; arpTick = true; }
+            if (++arpIntTimer >= arpPeriod) { arpIntTimer = 0; arpTick = true; }
         }
 
         if (arpTick && arpCount > 0) {
@@ -1058,7 +1140,7 @@ public:
             arpRand ^= arpRand << 5;
             uint8_t arpNote = arpNotes[arpIdx];
             if ((arpRand & 1u) && arpNote >= 24u) arpNote -= 12u;
-            CVOut2MIDINote(arpNote);
+            CVOutNote(1, arpNote);
             PulseOut2(true);
             arpGateTimer = ARP_GATE_LEN;
         }
@@ -1091,7 +1173,7 @@ public:
                     }
                 }
                 if (tunerMode && !tunerCounter) {
-                    TunerLedValues v = tunerLedValues(periodToCloseness(tunerPd.period()));
+                    TunerLedValues v = tunerLedValues(periodQ8ToCloseness(tunerPd.periodQ8()));
                     LedBrightness(4, v.flat);
                     LedBrightness(2, v.center);
                     LedBrightness(0, v.sharp);
@@ -1114,12 +1196,26 @@ private:
     bool         isUSBMIDIHost;
     int          writeHead;
     int          recordDecimate;
+    SampleCodec::Encoder encoder;
+
+    // Play heads, owned by the audio core: one per voice, one per voice for
+    // the crossfade into the loop start, and one parked at the loop start
+    SampleCodec::Reader voiceReader[MAX_VOICES];
+    SampleCodec::Reader xfadeReader[MAX_VOICES];
+    SampleCodec::Reader loopEntry;
     volatile int  presetIdx;
     int           presetFlashTimer;
     static constexpr int PRESET_FLASH_LEN = 4800;  // 100 ms at 48 kHz
     volatile int  loopStartPt;
     volatile bool    pendingDelayCapture;
     int              delayKnobY;
+    static constexpr int DELAY_BLOCK = 16;
+    int16_t          delayBuf[DELAY_BLOCK];
+    int              delayBufPos;
+
+    // Knobs, read at control rate
+    ControlClock<48> control;
+    ControlValue     knobMain, knobX, knobY;
     volatile bool    pendingCVNoteOn;
     volatile uint8_t pendingCVNote;
     bool             gateState;
@@ -1133,6 +1229,7 @@ private:
     int  arpIdx;        // current note index (-1 = reset)
     int  arpGateTimer;  // samples until Gate Out 2 goes low
     int  arpIntTimer;   // internal delay-synced tick counter
+    int  arpPeriod;     // internal tick period, samples (follows the Y knob)
     volatile bool midiClockTick;  // set by MIDI core on 0xF8
     bool hasMidiClock;            // true once first MIDI clock received (disables internal timer)
     uint8_t midiClockCount;       // counts 0xF8 ticks, fires arp step every MIDI_CLOCK_DIV
@@ -1145,8 +1242,9 @@ private:
     volatile uint8_t configMidiChan;  // channel being dialled in during config mode
     volatile uint8_t configVibRate;   // vibrato rate being dialled in during config mode
 
-    // Tuner (active when Audio In 2 is connected)
-    PitchDetector tunerPd;
+    // Tuner (active when Audio In 2 is connected).  ProcessSample feeds it;
+    // its pitch search runs in the MIDICore loop on core 0.
+    YinPitchDetector tunerPd;
     uint8_t       tunerCounter;      // wraps every 256 samples for display update
 
 public: